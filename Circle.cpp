@@ -1,9 +1,15 @@
 #include "Circle.hpp"
 
+#include "Instrumentation.hpp"
 #include "Line.hpp"
+#include "Parallel.hpp"
 #include "functions.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
 
 #include <exception>
 
@@ -50,9 +56,8 @@ Circle::Circle(const Point& a, const Point& b, const Point& c)
 
 bool Circle::isBelongs(const Point& a) const
 {
-   return almost_equal(power(a["x"] - _center["x"], 2) +
-                         power(a["y"] - _center["y"], 2),
-                       power(_radius, 2));
+   const double dx = a[0] - _center[0], dy = a[1] - _center[1];
+   return almost_equal(dx * dx + dy * dy, _radius * _radius);
 }
 
 bool Circle::isBelongs(const Point& a, int8_t dds) const
@@ -80,40 +85,18 @@ std::pair< double, double > Circle::x(double y) const
 }
 Angle Circle::getAngle(const Point& a) const
 {
-   Point exact { a };
-   if (!this->isBelongs(exact))
-      exact = getExactPoint(exact);
-   Line l(_center, exact);
-   switch (l.getType()) {
-      case LineType::CONST_X:
-         return (a["y"] > _center["y"]) ? Angle(90.0) : Angle(270.0);
-      case LineType::CONST_Y:
-         return (a["x"] > _center["x"]) ? Angle(0.0) : Angle(180.0);
-      case LineType::NORMAL: {
-         double degree = std::atan(l.K()) * 180 / M_PI;
-         if (a["x"] < _center["x"])
-            degree = 360.0 - degree;
-         if (degree < 0)
-            degree = 360.0 + degree;
-         return Angle(degree);
-      }
-      default:
-         break;
-   }
-   throw std::runtime_error("Cannot get angle of the point on circle");
+   if (a == _center)
+      throw std::runtime_error("Cannot get angle of the circle center");
+   return FastAngle::fromVector(Vector2::from(a) - Vector2::from(_center))
+     .toAngle();
 }
 Point Circle::getPoint(const Angle& a) const
 {
-   /**
-    * @brief Convert degrees in radians and getting not scaled X
-    */
-   const double xRaw = std::cos(a.degrees() * M_PI / 180.0);
-   const double x = xRaw * _radius + _center["x"];
-   auto yValues = y(x);
-   const double y = (a.degrees() > 180.0)
-                      ? std::min(yValues.first, yValues.second)
-                      : std::max(yValues.first, yValues.second);
-   return Point(x, y);
+   return getPoint(FastAngle::from(a));
+}
+Point Circle::getPoint(const FastAngle& a) const
+{
+   return (Vector2::from(_center) + a.unit() * _radius).toPoint();
 }
 
 Point Circle::getExactPoint(const Point& a, ApproximationMethod m) const
@@ -141,6 +124,123 @@ Point Circle::getExactPoint(const Point& a, ApproximationMethod m) const
    return Point(0.0, 0.0);
 }
 
+namespace impl {
+   /**
+    * @brief Circle as center and squared radius, without heap storage
+    */
+   struct Disk
+   {
+      Vector2 center;
+      double radius2;
+
+      bool contains(const Vector2& p) const
+      {
+         const Vector2 d = p - center;
+         // Relative tolerance, points on the border are inside
+         return d * d <= radius2 + eps * std::max(1.0, radius2);
+      }
+
+      static Disk byDiameter(const Vector2& a, const Vector2& b)
+      {
+         const Vector2 d = (b - a) * 0.5;
+         return { a + d, d * d };
+      }
+      /**
+       * @brief Circumcircle, for collinear points the circle on the
+       * farthest pair
+       */
+      static Disk byThree(const Vector2& a, const Vector2& b,
+                          const Vector2& c)
+      {
+         // Relative to a for precision
+         const Vector2 ab = b - a, ac = c - a;
+         const double ab2 = ab * ab, ac2 = ac * ac;
+         const double denominator = 2 * (ab | ac);
+         if (std::abs(denominator) <= eps * (ab2 + ac2)) {
+            const Vector2 bc = c - b;
+            if (bc * bc >= std::max(ab2, ac2))
+               return byDiameter(b, c);
+            return (ab2 >= ac2) ? byDiameter(a, b) : byDiameter(a, c);
+         }
+         const Vector2 offset = { (ac.y * ab2 - ab.y * ac2) / denominator,
+                                  (ab.x * ac2 - ac.x * ab2) / denominator };
+         return { a + offset, offset * offset };
+      }
+   };
+
+   Disk minEnclosingDisk(const Vector2* points, size_t count,
+                         uint32_t seed, size_t set)
+   {
+      if (count == 0)
+         throw std::invalid_argument(
+           "Circle::minEnclosing: cannot enclose empty set of points");
+      // Indices are shuffled instead of points
+      std::vector<uint> order(count);
+      std::iota(order.begin(), order.end(), 0);
+      // Small state, so seeding is cheap for many small sets
+      std::minstd_rand generator(seed ^ (set * 0x9E3779B9u));
+      std::shuffle(order.begin(), order.end(), generator);
+      auto at = [&](size_t k) -> const Vector2& { return points[order[k]]; };
+
+      // Each loop fixes one more point on the border
+      Disk disk = { at(0), 0 };
+      for (size_t i = 1; i < count; ++i) {
+         GEOMETRY_COUNT(PREDICATE_EVALUATIONS, 1);
+         if (disk.contains(at(i)))
+            continue;
+         disk = { at(i), 0 };
+         for (size_t j = 0; j < i; ++j) {
+            if (disk.contains(at(j)))
+               continue;
+            disk = Disk::byDiameter(at(i), at(j));
+            for (size_t k = 0; k < j; ++k)
+               if (!disk.contains(at(k)))
+                  disk = Disk::byThree(at(i), at(j), at(k));
+         }
+      }
+      return disk;
+   }
+} // namespace impl
+
+Circle Circle::minEnclosing(const std::vector<Point>& points, uint32_t seed)
+{
+   std::vector<Vector2> converted(points.size());
+   for (size_t i = 0; i < points.size(); ++i)
+      converted[i] = Vector2::from(points[i]);
+   return minEnclosing(converted.data(), converted.size(), seed);
+}
+
+Circle Circle::minEnclosing(const Vector2* points, size_t count,
+                            uint32_t seed)
+{
+   GEOMETRY_TIMER("Circle::minEnclosing");
+   const impl::Disk disk = impl::minEnclosingDisk(points, count, seed, 0);
+   return Circle(disk.center.toPoint(), std::sqrt(disk.radius2));
+}
+
+std::vector<Circle> Circle::minEnclosingBatch(
+  const std::vector<Vector2>& points, const std::vector<size_t>& offsets,
+  uint32_t seed)
+{
+   GEOMETRY_TIMER("Circle::minEnclosingBatch");
+   const size_t sets = offsets.empty() ? 0 : offsets.size() - 1;
+   std::vector<impl::Disk> disks(sets);
+   impl::parallelFor(0, sets, 64, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+         // Own random order for each set
+         disks[i] = impl::minEnclosingDisk(points.data() + offsets[i],
+                                           offsets[i + 1] - offsets[i],
+                                           seed,
+                                           i);
+      }
+   });
+   std::vector<Circle> result;
+   result.reserve(sets);
+   for (auto&& disk : disks)
+      result.emplace_back(disk.center.toPoint(), std::sqrt(disk.radius2));
+   return result;
+}
+
 Circle::~Circle()
 {
 }
@@ -2,9 +2,12 @@
 #define GEOMETRY_LIB_CIRCLE_HPP
 
 #include "Angle.hpp"
+#include "FastAngle.hpp"
 #include "Point.hpp"
+#include "Vector2.hpp"
 #include <cstdint>
 #include <utility>
+#include <vector>
 
 class Circle
 {
@@ -40,9 +43,9 @@ class Circle
    /**
     * @brief Get the angle of the point.
     *
-    * @param a Point. Should belongs to `this` circle, otherwise angle will be
-    * calculated approximately
-    * @return Angle of the point
+    * @param a Point. Only the direction from the center is used, so it
+    * may be off the circle
+    * @return Angle of the point, degrees in [0, 360)
     */
    Angle getAngle(const Point& a) const;
    /**
@@ -52,6 +55,7 @@ class Circle
     * @return Point defined by angle
     */
    Point getPoint(const Angle& a) const;
+   Point getPoint(const FastAngle& a) const;
    /**
     * @brief Get the exact point, that belongs to `this` circle
     *
@@ -61,6 +65,35 @@ class Circle
     */
    Point getExactPoint(const Point& a, ApproximationMethod m = BY_Y_AXIS) const;
 
+   /**
+    * @brief Get the smallest circle containing all points. Iterative
+    * randomized Welzl algorithm, expected O(n).
+    *
+    * @param points Points, at least one
+    * @param seed Seed of the random order of points, the same seed
+    * gives the same circle
+    * @return Circle - result circle, points on its border are inside
+    * it up to the eps relative error
+    */
+   static Circle minEnclosing(const std::vector<Point>& points,
+                              uint32_t seed = 0);
+   static Circle minEnclosing(const Vector2* points, size_t count,
+                              uint32_t seed = 0);
+   /**
+    * @brief Smallest enclosing circles of many point sets, computed in
+    * parallel
+    *
+    * @param points Points of all sets one after another
+    * @param offsets Set i is points[offsets[i]] .. points[offsets[i +
+    * 1] - 1], each set should not be empty
+    * @param seed Seed of random orders, the result does not depend on
+    * threads count
+    * @return Circles in input order
+    */
+   static std::vector<Circle> minEnclosingBatch(
+     const std::vector<Vector2>& points, const std::vector<size_t>& offsets,
+     uint32_t seed = 0);
+
    ~Circle();
 };
 
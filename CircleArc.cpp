@@ -21,13 +21,23 @@ void CircleArc::initByExactValues(const Point& a, const Point& b,
    const Angle& max = (min == angles[0]) ? angles[1] : angles[0];
    const Angle& between = angles[2];
 
-   if (between > max) {
+   // The arc goes counterclockwise from _boundaries[0] to
+   // _boundaries[1], through 0 degrees if they are decreasing
+   if (min < between && between < max) {
       _boundaries[0] = min;
       _boundaries[1] = max;
    } else {
       _boundaries[0] = max;
       _boundaries[1] = min;
    }
+
+   double sweep = _boundaries[1].degrees() - _boundaries[0].degrees();
+   if (sweep < 0)
+      sweep += 360;
+   _compact = CompactArc::make(Vector2::from(_circle.center()),
+                               _circle.radius(),
+                               _boundaries[0].degrees() * M_PI / 180,
+                               sweep * M_PI / 180);
 }
 
 CircleArc::CircleArc(const Circle& circle, const Point& a, const Point& b,
@@ -51,38 +61,23 @@ CircleArc::CircleArc(const Circle& circle, const Point& a, const Point& b,
 
 bool CircleArc::isBelongs(const Point& point) const
 {
-   Point tmp = point;
-   if (!_circle.isBelongs(tmp))
-      tmp = _circle.getExactPoint(tmp);
+   // Only the direction from the center matters, so points near the
+   // circle need no correction
+   return _compact.contains(Vector2::from(point));
+}
 
+bool CircleArc::isBelongs(const Angle& angle) const
+{
    const Angle &left = _boundaries[0], &right = _boundaries[1];
-   const Angle& input = _circle.getAngle(point);
-
-   if (left <= input && input <= right)
-      return true;
-   else
-      return false;
-
-   throw std::runtime_error(
-     "CircleArc::isBelongs: passed invalid point, we tried to fix it but no success.");
+   if (left <= right)
+      return left <= angle && angle <= right;
+   return left <= angle || angle <= right;
 }
 
 Point CircleArc::middle() const
 {
-   const Angle &left = _boundaries[0], &right = _boundaries[1];
-   double degrees;
-   if (left < right) {
-      degrees = (left + right).degrees() / 2;
-      return _circle.getPoint(Angle(degrees));
-   } else if (left > right) {
-      degrees = (left + (Angle::fullAngle() - left + right) / 2).degrees();
-      return _circle.getPoint(degrees);
-   } else {
-      return _circle.getPoint(left);
-   }
-
-   throw std::runtime_error(
-     "CircleArc::middle: cannot construct middle. This is bug.");
+   return _circle.getPoint(FastAngle::from(_boundaries[0]) +
+                           FastAngle::fromRadians(_compact.sweep / 2));
 }
 
 CircleArc::~CircleArc()
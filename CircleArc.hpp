@@ -3,6 +3,7 @@
 
 #include "Angle.hpp"
 #include "Circle.hpp"
+#include "CompactArc.hpp"
 
 class CircleArc
 {
@@ -14,6 +15,11 @@ class CircleArc
     * 1 - right angle
     */
    Angle _boundaries[2];
+   /**
+    * @brief The same arc with unit vectors of boundaries, for fast
+    * containment tests
+    */
+   CompactArc _compact;
 
    /**
     * @brief Does finish initialization by 3 points. The _circle must be defined
@@ -48,8 +54,25 @@ class CircleArc
     * @param point A point that need to check
     */
    bool isBelongs(const Point& point) const;
+   /**
+    * @brief Does check is the angle between boundaries of `this` arc.
+    * If the left boundary is greater than the right one, the arc
+    * passes through 0 degrees.
+    *
+    * @param angle Angle of a point of the circle, degrees in [0, 360)
+    */
+   bool isBelongs(const Angle& angle) const;
    Point middle() const;
 
+   const Circle& circle() const { return _circle; }
+   const Angle& left() const { return _boundaries[0]; }
+   const Angle& right() const { return _boundaries[1]; }
+   /**
+    * @brief Get trivially copyable copy of `this` arc, which does not
+    * depend on the circle lifetime
+    */
+   const CompactArc& compact() const { return _compact; }
+
    ~CircleArc();
 };
 
@@ -0,0 +1,245 @@
+#include "CircleIntersection.hpp"
+#include "Instrumentation.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace impl {
+   /**
+    * @brief Difference of squared distances which still counts as
+    * touching
+    */
+   inline double touchTolerance(double radius2)
+   {
+      return eps * std::max(1.0, radius2);
+   }
+
+   /**
+    * @brief Keep only points within angular boundaries of the arc
+    */
+   CircleIntersection::Result onArc(const CompactArc& arc,
+                                    CircleIntersection::Result result)
+   {
+      uint kept = 0;
+      for (uint i = 0; i < result.count; ++i)
+         if (arc.contains(result.points[i]))
+            result.points[kept++] = result.points[i];
+      result.count = kept;
+      return result;
+   }
+
+   /**
+    * @brief Common points of two arcs of one circle. Only overlap of
+    * positive length is coincident; arcs which touch by their ends
+    * have one or two common points.
+    */
+   CircleIntersection::Result sameCircleArcs(const CompactArc& a,
+                                             const CompactArc& b)
+   {
+      CircleIntersection::Result result;
+      // Angle from the begin of a to the begin of b, [0, 2pi)
+      double shift = std::atan2(a.begin | b.begin, a.begin * b.begin);
+      if (shift < 0)
+         shift += 2 * M_PI;
+      const double overlap =
+        std::max(std::min(a.sweep, shift + b.sweep) - shift,
+                 std::min(a.sweep, shift + b.sweep - 2 * M_PI));
+      if (overlap > eps) {
+         result.is_coincident = true;
+         return result;
+      }
+
+      const Vector2 ends[4] = { a.beginPoint(), a.endPoint(),
+                                b.beginPoint(), b.endPoint() };
+      const double distance2 = (eps * a.radius) * (eps * a.radius);
+      for (uint i = 0; i < 4 && result.count < 2; ++i) {
+         if (!(i < 2 ? b : a).contains(ends[i]))
+            continue;
+         bool is_new = true;
+         for (uint j = 0; j < result.count; ++j) {
+            const Vector2 d = result.points[j] - ends[i];
+            is_new = is_new && d * d > distance2;
+         }
+         if (is_new)
+            result.points[result.count++] = ends[i];
+      }
+      return result;
+   }
+} // namespace impl
+
+CircleIntersection::Result CircleIntersection::circleCircle(
+  const Vector2& center_a, double radius_a, const Vector2& center_b,
+  double radius_b)
+{
+   Result result;
+   const Vector2 d = center_b - center_a;
+   const double dd = d * d;
+   const double radius_a2 = radius_a * radius_a,
+                radius_b2 = radius_b * radius_b;
+   const double tolerance =
+     impl::touchTolerance(std::max(radius_a2, radius_b2));
+   if (!(dd > 0)) {
+      result.is_coincident = std::abs(radius_a2 - radius_b2) <= tolerance;
+      return result;
+   }
+   // Distance from center_a to the common chord, multiplied by |d|
+   const double along = (radius_a2 - radius_b2 + dd) / 2;
+   const double h2 = radius_a2 - along * along / dd;
+   if (h2 < -tolerance)
+      return result;
+   const Vector2 base = center_a + d * (along / dd);
+   if (h2 <= tolerance) {
+      result.points[0] = base;
+      result.count = 1;
+      return result;
+   }
+   const Vector2 offset = Vector2 { -d.y, d.x } * std::sqrt(h2 / dd);
+   result.points[0] = base - offset;
+   result.points[1] = base + offset;
+   result.count = 2;
+   return result;
+}
+
+CircleIntersection::Result CircleIntersection::circleLine(
+  const Vector2& center, double radius, const HomogeneousLine& line)
+{
+   Result result;
+   const double nn = line.normal() * line.normal();
+   if (!(nn > 0))
+      return result;
+   const double value = line.value(center);
+   const double radius2 = radius * radius;
+   const double h2 = radius2 - value * value / nn;
+   const double tolerance = impl::touchTolerance(radius2);
+   if (h2 < -tolerance)
+      return result;
+   const Vector2 foot = center - line.normal() * (value / nn);
+   if (h2 <= tolerance) {
+      result.points[0] = foot;
+      result.count = 1;
+      return result;
+   }
+   const Vector2 offset = line.direction() * std::sqrt(h2 / nn);
+   result.points[0] = foot - offset;
+   result.points[1] = foot + offset;
+   result.count = 2;
+   return result;
+}
+
+CircleIntersection::Result CircleIntersection::circleSegment(
+  const Vector2& center, double radius, const CompactSegment& segment)
+{
+   const double length2 = segment.delta * segment.delta;
+   if (!(length2 > 0)) {
+      // The segment is a point
+      Result result;
+      const Vector2 d = segment.begin - center;
+      const double radius2 = radius * radius;
+      if (std::abs(d * d - radius2) <= impl::touchTolerance(radius2)) {
+         result.points[0] = segment.begin;
+         result.count = 1;
+      }
+      return result;
+   }
+   Result result = circleLine(
+     center, radius, HomogeneousLine::through(segment.begin, segment.end()));
+   uint kept = 0;
+   for (uint i = 0; i < result.count; ++i) {
+      const double t =
+        ((result.points[i] - segment.begin) * segment.delta) / length2;
+      if (t >= -eps && t <= 1 + eps)
+         result.points[kept++] = result.points[i];
+   }
+   result.count = kept;
+   return result;
+}
+
+CircleIntersection::Result CircleIntersection::intersect(const Circle& a,
+                                                         const Circle& b)
+{
+   return circleCircle(Vector2::from(a.center()),
+                       a.radius(),
+                       Vector2::from(b.center()),
+                       b.radius());
+}
+
+CircleIntersection::Result CircleIntersection::intersect(
+  const Circle& circle, const Line& line)
+{
+   return circleLine(
+     Vector2::from(circle.center()), circle.radius(), line.homogeneous());
+}
+
+CircleIntersection::Result CircleIntersection::intersect(
+  const Circle& circle, const LineSegment& segment)
+{
+   return circleSegment(
+     Vector2::from(circle.center()), circle.radius(), segment.compact());
+}
+
+CircleIntersection::Result CircleIntersection::intersect(
+  const CircleArc& arc, const Circle& circle)
+{
+   return impl::onArc(arc.compact(), intersect(arc.circle(), circle));
+}
+
+CircleIntersection::Result CircleIntersection::intersect(
+  const CircleArc& arc, const Line& line)
+{
+   return impl::onArc(arc.compact(), intersect(arc.circle(), line));
+}
+
+CircleIntersection::Result CircleIntersection::intersect(
+  const CircleArc& arc, const LineSegment& segment)
+{
+   return impl::onArc(arc.compact(), intersect(arc.circle(), segment));
+}
+
+CircleIntersection::Result CircleIntersection::intersect(
+  const CompactArc& a, const CompactArc& b)
+{
+   const Result result = impl::onArc(
+     b,
+     impl::onArc(a, circleCircle(a.center, a.radius, b.center, b.radius)));
+   if (result.is_coincident)
+      return impl::sameCircleArcs(a, b);
+   return result;
+}
+
+CircleIntersection::Result CircleIntersection::intersect(
+  const CompactArc& arc, const HomogeneousLine& line)
+{
+   return impl::onArc(arc, circleLine(arc.center, arc.radius, line));
+}
+
+CircleIntersection::Result CircleIntersection::intersect(
+  const CompactArc& arc, const CompactSegment& segment)
+{
+   return impl::onArc(arc, circleSegment(arc.center, arc.radius, segment));
+}
+
+std::vector<CircleIntersection::Hit> CircleIntersection::intersectBatch(
+  const std::vector<CompactSegment>& segments, const CircleSet& circles)
+{
+   GEOMETRY_TIMER("CircleIntersection::intersectBatch");
+   return impl::parallelCollect<Hit>(
+     segments.size(),
+     256,
+     [&](size_t begin, size_t end, std::vector<Hit>& part) {
+        std::vector<uint> candidates;
+        for (size_t i = begin; i < end; ++i) {
+           const CompactSegment& s = segments[i];
+           candidates.clear();
+           circles.overlapping(
+             { s.min_x, s.min_y }, { s.max_x, s.max_y }, candidates);
+           GEOMETRY_COUNT(PREDICATE_EVALUATIONS, candidates.size());
+           for (uint c : candidates) {
+              const Result result =
+                circleSegment(circles.center(c), circles.radius(c), s);
+              if (result.count > 0)
+                 part.push_back({ uint(i), c, result });
+           }
+        }
+     });
+}
@@ -0,0 +1,96 @@
+#ifndef GEOMETRY_LIB_CIRCLEINTERSECTION_HPP
+#define GEOMETRY_LIB_CIRCLEINTERSECTION_HPP
+
+#include <vector>
+
+#include "Circle.hpp"
+#include "CircleArc.hpp"
+#include "CircleSet.hpp"
+#include "CompactArc.hpp"
+#include "CompactSegment.hpp"
+#include "HomogeneousLine.hpp"
+#include "Line.hpp"
+#include "LineSegment.hpp"
+#include "Vector2.hpp"
+#include "functions.hpp"
+
+/**
+ * @brief Closed-form intersections of circles with circles, lines and
+ * segments. Results have fixed capacity, so no heap storage is used.
+ *
+ * Touching within eps (relative to the squared radius) gives one
+ * point. Arcs keep only points within their angular boundaries, which
+ * are checked by CompactArc::contains.
+ */
+class CircleIntersection
+{
+  public:
+   struct Result
+   {
+      /**
+       * @brief The first `count` points are valid
+       */
+      Vector2 points[2] = {};
+      uint count = 0;
+      /**
+       * @brief Circles are equal: infinitely many common points, none
+       * of them is reported
+       */
+      bool is_coincident = false;
+   };
+   struct Hit
+   {
+      uint segment = 0, circle = 0;
+      Result result;
+   };
+
+   /**
+    * @brief The first point is on the right of the direction from
+    * center_a to center_b
+    */
+   static Result circleCircle(const Vector2& center_a, double radius_a,
+                              const Vector2& center_b, double radius_b);
+   /**
+    * @brief Points in order of the line direction
+    */
+   static Result circleLine(const Vector2& center, double radius,
+                            const HomogeneousLine& line);
+   /**
+    * @brief Points in order from the segment begin to its end
+    */
+   static Result circleSegment(const Vector2& center, double radius,
+                               const CompactSegment& segment);
+
+   static Result intersect(const Circle& a, const Circle& b);
+   static Result intersect(const Circle& circle, const Line& line);
+   static Result intersect(const Circle& circle,
+                           const LineSegment& segment);
+   static Result intersect(const CircleArc& arc, const Circle& circle);
+   static Result intersect(const CircleArc& arc, const Line& line);
+   static Result intersect(const CircleArc& arc,
+                           const LineSegment& segment);
+
+   /**
+    * @brief Common points of two arcs. Arcs of one circle which
+    * overlap by positive length are reported as coincident, without
+    * points; arcs of one circle touching by ends give the common ends.
+    */
+   static Result intersect(const CompactArc& a, const CompactArc& b);
+   static Result intersect(const CompactArc& arc,
+                           const HomogeneousLine& line);
+   static Result intersect(const CompactArc& arc,
+                           const CompactSegment& segment);
+
+   /**
+    * @brief All intersecting pairs of segments and circles, computed in
+    * parallel. The grid of `circles` culls pairs by bounding boxes.
+    *
+    * @return hits ordered by segment, the order does not depend on
+    * threads count
+    */
+   static std::vector<Hit> intersectBatch(
+     const std::vector<CompactSegment>& segments,
+     const CircleSet& circles);
+};
+
+#endif // GEOMETRY_LIB_CIRCLEINTERSECTION_HPP
@@ -0,0 +1,249 @@
+#include "CircleSet.hpp"
+#include "Instrumentation.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace impl {
+   /**
+    * @brief Circles located at once by CircleSet kernels
+    */
+   const size_t block_size = 64;
+} // namespace impl
+
+void CircleSet::Columns::resize(size_t size)
+{
+   x.resize(size);
+   y.resize(size);
+   inner2.resize(size);
+   outer2.resize(size);
+}
+
+void CircleSet::Columns::locate(const Vector2& p, size_t begin,
+                                size_t end, double* result) const
+{
+   const double *xs = x.data(), *ys = y.data(), *inner = inner2.data(),
+                *outer = outer2.data();
+   for (size_t i = begin; i < end; ++i) {
+      const double dx = p.x - xs[i], dy = p.y - ys[i];
+      const double d2 = dx * dx + dy * dy;
+      result[i - begin] =
+        (d2 <= outer[i] ? 1.0 : 0.0) + (d2 < inner[i] ? 1.0 : 0.0);
+   }
+}
+
+CircleSet::CircleSet(const std::vector<Circle>& circles,
+                     double cell_size)
+{
+   _circles.resize(circles.size());
+   _radius.resize(circles.size());
+   for (size_t i = 0; i < circles.size(); ++i) {
+      const Point center = circles[i].center();
+      set(i, center[0], center[1], circles[i].radius());
+   }
+   build(cell_size);
+}
+
+CircleSet::CircleSet(const std::vector<Vector2>& centers,
+                     const std::vector<double>& radii, double cell_size)
+{
+   if (centers.size() != radii.size())
+      throw std::invalid_argument(
+        "CircleSet: centers and radii counts differ");
+   _circles.resize(centers.size());
+   _radius.resize(centers.size());
+   for (size_t i = 0; i < centers.size(); ++i)
+      set(i, centers[i].x, centers[i].y, radii[i]);
+   build(cell_size);
+}
+
+void CircleSet::set(size_t i, double x, double y, double radius)
+{
+   if (!(radius >= 0) || std::isinf(radius) || std::isinf(x) ||
+       std::isinf(y))
+      throw std::invalid_argument("CircleSet: incorrect circle");
+   const double radius2 = radius * radius;
+   const double tolerance = eps * std::max(1.0, radius2);
+   _circles.x[i] = x;
+   _circles.y[i] = y;
+   _circles.inner2[i] = radius2 - tolerance;
+   _circles.outer2[i] = radius2 + tolerance;
+   _radius[i] = radius;
+}
+
+uint CircleSet::column(double x) const
+{
+   const double c = (x - _min_x) / _cell_size;
+   return c <= 0 ? 0 : std::min<double>(_cols - 1, c);
+}
+
+uint CircleSet::row(double y) const
+{
+   const double r = (y - _min_y) / _cell_size;
+   return r <= 0 ? 0 : std::min<double>(_rows - 1, r);
+}
+
+void CircleSet::build(double cell_size)
+{
+   const size_t n = size();
+   // Bounding boxes include the border tolerance
+   std::vector<double> outer(n);
+   for (size_t i = 0; i < n; ++i)
+      outer[i] = std::sqrt(_circles.outer2[i]);
+   double max_x = 0, max_y = 0, extent = 0;
+   if (n > 0) {
+      _min_x = _min_y = std::numeric_limits<double>::max();
+      max_x = max_y = std::numeric_limits<double>::lowest();
+   }
+   for (size_t i = 0; i < n; ++i) {
+      _min_x = std::min(_min_x, _circles.x[i] - outer[i]);
+      _min_y = std::min(_min_y, _circles.y[i] - outer[i]);
+      max_x = std::max(max_x, _circles.x[i] + outer[i]);
+      max_y = std::max(max_y, _circles.y[i] + outer[i]);
+      extent += 2 * outer[i];
+   }
+   const double width = max_x - _min_x, height = max_y - _min_y;
+   if (!(cell_size > 0) && n > 0) {
+      // A typical circle covers few cells
+      cell_size = extent / n;
+      if (!(cell_size > 0))
+         cell_size = std::max(width, height) / n;
+   }
+   _cell_size = (cell_size > 0) ? cell_size : 1;
+   // Limit cells count by 4 cells per circle for tiny cell_size
+   const double max_side = 2 * std::sqrt(double(n)) + 1;
+   _cols = std::min(max_side, std::floor(width / _cell_size) + 1);
+   _rows = std::min(max_side, std::floor(height / _cell_size) + 1);
+   _cell_size =
+     std::max(_cell_size, std::max(width / _cols, height / _rows));
+
+   // Counting pass, then scatter of circle copies into cells
+   auto forEachCell = [&](size_t i, auto&& f) {
+      for (uint r = row(_circles.y[i] - outer[i]),
+                r_end = row(_circles.y[i] + outer[i]);
+           r <= r_end;
+           ++r)
+         for (uint c = column(_circles.x[i] - outer[i]),
+                   c_end = column(_circles.x[i] + outer[i]);
+              c <= c_end;
+              ++c)
+            f(size_t(r) * _cols + c);
+   };
+   _offsets.assign(cellsCount() + 1, 0);
+   for (size_t i = 0; i < n; ++i)
+      forEachCell(i, [&](size_t cell) { ++_offsets[cell + 1]; });
+   for (size_t c = 0; c < cellsCount(); ++c)
+      _offsets[c + 1] += _offsets[c];
+   _items.resize(_offsets.back());
+   _cells.resize(_offsets.back());
+   std::vector<size_t> fill(_offsets.begin(), _offsets.end() - 1);
+   for (size_t i = 0; i < n; ++i)
+      forEachCell(i, [&](size_t cell) {
+         const size_t k = fill[cell]++;
+         _items[k] = i;
+         _cells.x[k] = _circles.x[i];
+         _cells.y[k] = _circles.y[i];
+         _cells.inner2[k] = _circles.inner2[i];
+         _cells.outer2[k] = _circles.outer2[i];
+      });
+}
+
+template<class F>
+void CircleSet::forEachHit(const Vector2& p, F&& f) const
+{
+   if (size() == 0)
+      return;
+   const size_t cell = size_t(row(p.y)) * _cols + column(p.x);
+   GEOMETRY_COUNT(GRID_CELLS_VISITED, 1);
+   GEOMETRY_COUNT(PREDICATE_EVALUATIONS,
+                  _offsets[cell + 1] - _offsets[cell]);
+   // Locations are computed by blocks, then scanned
+   double locations[impl::block_size];
+   for (size_t begin = _offsets[cell]; begin < _offsets[cell + 1];
+        begin += impl::block_size) {
+      const size_t end =
+        std::min(begin + impl::block_size, _offsets[cell + 1]);
+      _cells.locate(p, begin, end, locations);
+      for (size_t k = begin; k < end; ++k)
+         if (locations[k - begin] != OUTSIDE)
+            f(_items[k]);
+   }
+}
+
+void CircleSet::locateAll(const Vector2& p, Location* result) const
+{
+   GEOMETRY_COUNT(PREDICATE_EVALUATIONS, size());
+   double locations[impl::block_size];
+   for (size_t begin = 0; begin < size(); begin += impl::block_size) {
+      const size_t end = std::min(begin + impl::block_size, size());
+      _circles.locate(p, begin, end, locations);
+      for (size_t i = begin; i < end; ++i)
+         result[i] = static_cast<Location>(locations[i - begin]);
+   }
+}
+
+std::vector<uint> CircleSet::containing(const Vector2& p) const
+{
+   // Items of a cell are in increasing order
+   std::vector<uint> result;
+   forEachHit(p, [&](uint circle) { result.push_back(circle); });
+   return result;
+}
+
+CircleSet::pair_list_t CircleSet::hits(
+  const std::vector<Vector2>& points) const
+{
+   GEOMETRY_TIMER("CircleSet::hits");
+   using pair_t = pair_list_t::value_type;
+   return impl::parallelCollect<pair_t>(
+     points.size(),
+     1024,
+     [&](size_t begin, size_t end, pair_list_t& part) {
+        for (size_t i = begin; i < end; ++i)
+           forEachHit(points[i],
+                      [&](uint circle) { part.emplace_back(i, circle); });
+     });
+}
+
+std::vector<uint> CircleSet::hitCounts(
+  const std::vector<Vector2>& points) const
+{
+   GEOMETRY_TIMER("CircleSet::hitCounts");
+   std::vector<uint> result(points.size(), 0);
+   impl::parallelFor(0, points.size(), 1024, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i)
+         forEachHit(points[i], [&](uint) { ++result[i]; });
+   });
+   return result;
+}
+
+void CircleSet::overlapping(const Vector2& min, const Vector2& max,
+                            std::vector<uint>& result) const
+{
+   if (size() == 0)
+      return;
+   for (uint r = row(min.y), r_end = row(max.y); r <= r_end; ++r)
+      for (uint c = column(min.x), c_end = column(max.x); c <= c_end;
+           ++c) {
+         const size_t cell = size_t(r) * _cols + c;
+         GEOMETRY_COUNT(GRID_CELLS_VISITED, 1);
+         for (size_t k = _offsets[cell]; k < _offsets[cell + 1]; ++k) {
+            // The same box as in build()
+            const double outer = std::sqrt(_cells.outer2[k]);
+            const double min_x = _cells.x[k] - outer,
+                         min_y = _cells.y[k] - outer;
+            if (min_x > max.x || _cells.x[k] + outer < min.x ||
+                min_y > max.y || _cells.y[k] + outer < min.y)
+               continue;
+            // Report the circle only in the cell of the lower left
+            // corner of the boxes overlap
+            if (row(std::max(min_y, min.y)) != r ||
+                column(std::max(min_x, min.x)) != c)
+               continue;
+            result.push_back(_items[k]);
+         }
+      }
+}
@@ -0,0 +1,119 @@
+#ifndef GEOMETRY_LIB_CIRCLESET_HPP
+#define GEOMETRY_LIB_CIRCLESET_HPP
+
+#include <utility>
+#include <vector>
+
+#include "Circle.hpp"
+#include "Vector2.hpp"
+#include "functions.hpp"
+
+/**
+ * @brief Immutable set of circles for hit-testing of many points.
+ *
+ * Circles are stored as structure of arrays, so tests of one point
+ * against a range of circles are branchless loops over contiguous
+ * doubles. A uniform grid culls circles: each circle is copied into
+ * every cell its bounding box overlaps (CSR form, like SegmentGrid),
+ * so a point is tested only against circles of its own cell.
+ *
+ * A point is on the border of a circle if its squared distance from
+ * the center differs from the squared radius by at most eps relative
+ * to the squared radius.
+ */
+class CircleSet
+{
+  public:
+   enum Location
+   {
+      OUTSIDE = 0,
+      BORDER = 1,
+      INSIDE = 2
+   };
+   using pair_list_t = std::vector<std::pair<uint, uint>>;
+
+  private:
+   /**
+    * @brief Circles as arrays: centers, radii and squared distances
+    * bounding the border
+    */
+   struct Columns
+   {
+      std::vector<double> x, y, inner2, outer2;
+
+      void resize(size_t size);
+      /**
+       * @brief Locations of p relative to circles begin .. end - 1.
+       * Values are doubles, so the loop is vectorized even with
+       * plain SSE2.
+       */
+      void locate(const Vector2& p, size_t begin, size_t end,
+                  double* result) const;
+   };
+
+   Columns _circles;
+   std::vector<double> _radius;
+   double _min_x = 0, _min_y = 0, _cell_size = 1;
+   uint _cols = 1, _rows = 1;
+   std::vector<size_t> _offsets;
+   std::vector<uint> _items;
+   Columns _cells;
+
+   uint column(double x) const;
+   uint row(double y) const;
+   void set(size_t i, double x, double y, double radius);
+   void build(double cell_size);
+   /**
+    * @brief Calls f(circle) for each circle containing p or having it
+    * on the border, in increasing order
+    */
+   template<class F>
+   void forEachHit(const Vector2& p, F&& f) const;
+
+  public:
+   /**
+    * @param cell_size side of a grid cell, if not positive it is
+    * chosen by average circle diameter
+    */
+   CircleSet(const std::vector<Circle>& circles, double cell_size = 0);
+   CircleSet(const std::vector<Vector2>& centers,
+             const std::vector<double>& radii, double cell_size = 0);
+
+   size_t size() const { return _radius.size(); }
+   Vector2 center(size_t i) const
+   {
+      return { _circles.x.at(i), _circles.y.at(i) };
+   }
+   double radius(size_t i) const { return _radius.at(i); }
+   size_t cellsCount() const { return size_t(_cols) * _rows; }
+   double cellSize() const { return _cell_size; }
+
+   /**
+    * @brief Location of p relative to every circle, without culling
+    *
+    * @param result size() values in order of circles
+    */
+   void locateAll(const Vector2& p, Location* result) const;
+   /**
+    * @brief Numbers of circles containing p (border included), sorted
+    */
+   std::vector<uint> containing(const Vector2& p) const;
+   /**
+    * @brief Pairs (point, circle) for circles containing points
+    * (border included), computed in parallel. Ordered by point, then
+    * by circle; the order does not depend on threads count.
+    */
+   pair_list_t hits(const std::vector<Vector2>& points) const;
+   /**
+    * @brief Numbers of circles containing each point (border included)
+    */
+   std::vector<uint> hitCounts(const std::vector<Vector2>& points) const;
+   /**
+    * @brief Appends numbers of circles whose bounding boxes overlap the
+    * box [min, max], each circle once, in order of grid cells
+    */
+   void overlapping(const Vector2& min, const Vector2& max,
+                    std::vector<uint>& result) const;
+};
+
+#endif // GEOMETRY_LIB_CIRCLESET_HPP
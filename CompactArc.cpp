@@ -0,0 +1,95 @@
+#include "CompactArc.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+CompactArc CompactArc::make(const Vector2& center, double radius,
+                            double start, double sweep)
+{
+   if (!(radius >= 0) || std::isinf(radius) || std::isinf(start) ||
+       std::isnan(sweep))
+      throw std::invalid_argument("CompactArc: incorrect arc");
+   if (sweep < 0) {
+      start += sweep;
+      sweep = -sweep;
+   }
+   sweep = std::min(sweep, 2 * M_PI);
+   const Vector2 begin = { std::cos(start), std::sin(start) };
+   const Vector2 end = { std::cos(start + sweep), std::sin(start + sweep) };
+   return { center, radius, begin, end, sweep };
+}
+
+CompactArc CompactArc::through(const Vector2& a, const Vector2& middle,
+                               const Vector2& b)
+{
+   // Circumcircle relative to a for precision
+   const Vector2 am = middle - a, ab = b - a;
+   const double am2 = am * am, ab2 = ab * ab;
+   const double denominator = 2 * (am | ab);
+   if (std::abs(denominator) <= eps * (am2 + ab2))
+      throw std::invalid_argument(
+        "CompactArc: cannot construct arc by points on the same line");
+   const Vector2 offset = { (ab.y * am2 - am.y * ab2) / denominator,
+                            (am.x * ab2 - ab.x * am2) / denominator };
+   const Vector2 center = a + offset;
+   const double radius = std::sqrt(offset * offset);
+   auto angle = [&](const Vector2& p) {
+      return std::atan2(p.y - center.y, p.x - center.x);
+   };
+   // Counterclockwise sweep from a to b, reversed if it misses middle
+   const double start = angle(a);
+   double sweep = angle(b) - start;
+   if (sweep < 0)
+      sweep += 2 * M_PI;
+   double to_middle = angle(middle) - start;
+   if (to_middle < 0)
+      to_middle += 2 * M_PI;
+   if (to_middle > sweep)
+      sweep -= 2 * M_PI;
+   CompactArc result = make(center, radius, start, sweep);
+   // Exact ends
+   if (sweep >= 0) {
+      result.begin = (a - center) * (1 / radius);
+      result.end = (b - center) * (1 / radius);
+   } else {
+      result.begin = (b - center) * (1 / radius);
+      result.end = (a - center) * (1 / radius);
+   }
+   return result;
+}
+
+size_t CompactArc::chordsCount(double tolerance) const
+{
+   if (!(tolerance > 0))
+      throw std::invalid_argument(
+        "CompactArc: tolerance should be positive");
+   if (tolerance >= radius)
+      return std::max(1.0, std::ceil(sweep / M_PI));
+   // Sagitta of a chord with angle a is radius * (1 - cos(a / 2)) =
+   // 2 * radius * sin(a / 4)^2; the latter does not round to 0 for
+   // small tolerances
+   const double max_angle =
+     4 * std::asin(std::sqrt(tolerance / radius / 2));
+   const double count = std::ceil(sweep / max_angle);
+   if (!(count <= max_chords))
+      throw std::invalid_argument(
+        "CompactArc: tolerance is too small for the radius");
+   return std::max(1.0, count);
+}
+
+void CompactArc::tessellate(double tolerance,
+                            std::vector<Vector2>& points) const
+{
+   const size_t count = chordsCount(tolerance);
+   const double step = sweep / count;
+   // Rotation by step as a complex multiplication, no trigonometry
+   // per point
+   const double c = std::cos(step), s = std::sin(step);
+   Vector2 direction = begin;
+   for (size_t i = 0; i < count; ++i) {
+      points.push_back(center + direction * radius);
+      direction = { direction.x * c - direction.y * s,
+                    direction.x * s + direction.y * c };
+   }
+   points.push_back(endPoint());
+}
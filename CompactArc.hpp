@@ -0,0 +1,83 @@
+#ifndef GEOMETRY_LIB_COMPACTARC_HPP
+#define GEOMETRY_LIB_COMPACTARC_HPP
+
+#include <cmath>
+#include <vector>
+
+#include "Vector2.hpp"
+#include "functions.hpp"
+
+/**
+ * @brief Trivially copyable circle arc: center, radius, unit vectors
+ * from the center to the ends and the sweep angle. 64 bytes, no heap
+ * storage. The arc goes counterclockwise from `begin` to `end`.
+ *
+ * Used by batch and path processing instead of CircleArc, which
+ * refers to a Circle and keeps its boundaries as angles.
+ */
+struct CompactArc
+{
+   Vector2 center;
+   double radius;
+   Vector2 begin, end;
+   /**
+    * @brief Angle from begin to end in radians, [0, 2pi]
+    */
+   double sweep;
+
+   /**
+    * @param start angle of the first end in radians
+    * @param sweep angle from the first end to the second one, negative
+    * for clockwise arcs (they are stored reversed)
+    */
+   static CompactArc make(const Vector2& center, double radius,
+                          double start, double sweep);
+   /**
+    * @brief Arc from a to b through `middle`
+    */
+   static CompactArc through(const Vector2& a, const Vector2& middle,
+                             const Vector2& b);
+
+   Vector2 beginPoint() const { return center + begin * radius; }
+   Vector2 endPoint() const { return center + end * radius; }
+   double length() const { return radius * sweep; }
+
+   /**
+    * @brief Checks if direction from the center to p is within `this`
+    * arc: sign tests of two cross products (and a dot product for
+    * arcs not greater than a half circle). p is not required to lie
+    * on the circle.
+    */
+   bool contains(const Vector2& p) const
+   {
+      const Vector2 d = p - center;
+      const double tolerance = eps * radius;
+      const bool after_begin = (begin | d) >= -tolerance,
+                 before_end = (d | end) >= -tolerance;
+      if (sweep <= M_PI)
+         return after_begin & before_end &
+                ((begin + end) * d >= -tolerance);
+      return (sweep >= 2 * M_PI) | after_begin | before_end;
+   }
+
+   /**
+    * @brief Upper limit of chordsCount, 2^24
+    */
+   static const size_t max_chords = size_t(1) << 24;
+
+   /**
+    * @brief Number of chords approximating `this` arc with sagitta not
+    * greater than `tolerance`
+    * @throw std::invalid_argument if `tolerance` is not positive or
+    * needs more than max_chords chords
+    */
+   size_t chordsCount(double tolerance) const;
+   /**
+    * @brief Appends chordsCount(tolerance) + 1 points from the begin
+    * to the end of the arc to `points`; the buffer is reused by
+    * callers, so it is not cleared
+    */
+   void tessellate(double tolerance, std::vector<Vector2>& points) const;
+};
+
+#endif // GEOMETRY_LIB_COMPACTARC_HPP
@@ -0,0 +1,110 @@
+#include "CompactSegment.hpp"
+#include "Instrumentation.hpp"
+
+#include <set>
+
+void CompactSegment::intersectPairs(const CompactSegment* a,
+                                    const CompactSegment* b,
+                                    size_t count, uint8_t* result)
+{
+   GEOMETRY_COUNT(PREDICATE_EVALUATIONS, count);
+   for (size_t i = 0; i < count; ++i)
+      result[i] = isIntersection(a[i], b[i]);
+}
+
+size_t CompactSegment::intersectAll(const CompactSegment& segment,
+                                    const CompactSegment* segments,
+                                    size_t count, uint* hits)
+{
+   GEOMETRY_COUNT(PREDICATE_EVALUATIONS, count);
+   size_t found = 0;
+   for (size_t i = 0; i < count; ++i) {
+      // Unconditional store, the counter moves only on a hit
+      hits[found] = i;
+      found += isIntersection(segment, segments[i]);
+   }
+   return found;
+}
+
+namespace impl {
+   struct SweepEvent
+   {
+      double x;
+      int type; // +1 for left end, -1 for right end
+      uint id;
+
+      bool operator<(const SweepEvent& other) const
+      {
+         if (std::abs(x - other.x) > eps)
+            return x < other.x;
+         return type > other.type;
+      }
+   };
+
+   /**
+    * @brief Order of segments along the sweep line
+    */
+   struct SweepLess
+   {
+      const CompactSegment* segments;
+
+      static double y(const CompactSegment& s, double x)
+      {
+         if (s.delta.x == 0)
+            return s.min_y;
+         return s.begin.y + s.delta.y * (x - s.begin.x) / s.delta.x;
+      }
+      bool operator()(uint a, uint b) const
+      {
+         const CompactSegment &sa = segments[a], &sb = segments[b];
+         const double x = std::max(sa.min_x, sb.min_x);
+         return y(sa, x) < y(sb, x) - eps;
+      }
+   };
+} // namespace impl
+
+bool CompactSegment::isAnyIntersection(
+  const std::vector<CompactSegment>& segments)
+{
+   const uint n = segments.size();
+   std::vector<impl::SweepEvent> events;
+   events.reserve(2 * n);
+   for (uint i = 0; i < n; ++i) {
+      events.push_back({ segments[i].min_x, +1, i });
+      events.push_back({ segments[i].max_x, -1, i });
+   }
+   std::sort(events.begin(), events.end());
+
+   using status_t = std::set<uint, impl::SweepLess>;
+   status_t status(impl::SweepLess { segments.data() });
+   std::vector<status_t::iterator> positions(n);
+   auto isIntersected = [&](uint a, uint b) {
+      GEOMETRY_COUNT(PREDICATE_EVALUATIONS, 1);
+      return isIntersection(segments[a], segments[b]);
+   };
+
+   for (auto&& event : events) {
+      const uint id = event.id;
+      if (event.type == +1) {
+         auto next = status.lower_bound(id);
+         if (next != status.end() && isIntersected(*next, id))
+            return true;
+         if (next != status.begin() &&
+             isIntersected(*std::prev(next), id))
+            return true;
+         auto inserted = status.insert(next, id);
+         // Equivalent key: both segments pass the same point of the
+         // sweep line
+         if (*inserted != id)
+            return true;
+         positions[id] = inserted;
+      } else {
+         auto next = std::next(positions[id]);
+         if (next != status.end() && positions[id] != status.begin() &&
+             isIntersected(*next, *std::prev(positions[id])))
+            return true;
+         status.erase(positions[id]);
+      }
+   }
+   return false;
+}
@@ -0,0 +1,101 @@
+#ifndef GEOMETRY_LIB_COMPACTSEGMENT_HPP
+#define GEOMETRY_LIB_COMPACTSEGMENT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Vector2.hpp"
+#include "functions.hpp"
+
+/**
+ * @brief Trivially copyable line segment: begin point, direction
+ * (end - begin) and cached bounding box. 64 bytes, no heap storage.
+ *
+ * Used by intersection kernels instead of LineSegment, which holds a
+ * Line and two heap-backed Points.
+ */
+struct CompactSegment
+{
+   Vector2 begin, delta;
+   double min_x, min_y, max_x, max_y;
+
+   static CompactSegment make(const Vector2& a, const Vector2& b)
+   {
+      return { a,
+               b - a,
+               std::min(a.x, b.x),
+               std::min(a.y, b.y),
+               std::max(a.x, b.x),
+               std::max(a.y, b.y) };
+   }
+
+   Vector2 end() const { return begin + delta; }
+
+   /**
+    * @brief Sign of cross product delta x (p - begin), values closer
+    * than eps to zero are zero
+    */
+   int orientation(const Vector2& p) const
+   {
+      const double cross = delta | (p - begin);
+      return (cross > eps) - (cross < -eps);
+   }
+   bool isBoxOverlap(const CompactSegment& other) const
+   {
+      return (min_x <= other.max_x + eps) &
+             (other.min_x <= max_x + eps) &
+             (min_y <= other.max_y + eps) & (other.min_y <= max_y + eps);
+   }
+   bool isBoxContains(const Vector2& p) const
+   {
+      return (min_x - eps <= p.x) & (p.x <= max_x + eps) &
+             (min_y - eps <= p.y) & (p.y <= max_y + eps);
+   }
+   /**
+    * @brief Checks if point p belongs to `this` segment
+    */
+   bool isBelongs(const Vector2& p) const
+   {
+      return isBoxContains(p) & (orientation(p) == 0);
+   }
+
+   /**
+    * @brief Checks if segments a and b have a common point (touching
+    * and collinear overlapping segments intersect)
+    */
+   static bool isIntersection(const CompactSegment& a,
+                              const CompactSegment& b)
+   {
+      const int o1 = a.orientation(b.begin), o2 = a.orientation(b.end()),
+                o3 = b.orientation(a.begin), o4 = b.orientation(a.end());
+      // For collinear segments all orientations are zero and the
+      // boxes test is exact
+      return a.isBoxOverlap(b) & (o1 * o2 <= 0) & (o3 * o4 <= 0);
+   }
+
+   /**
+    * @brief Element-wise test: result[i] = isIntersection(a[i], b[i])
+    */
+   static void intersectPairs(const CompactSegment* a,
+                              const CompactSegment* b, size_t count,
+                              uint8_t* result);
+   /**
+    * @brief Test one segment against an array
+    *
+    * @param hits indices of intersected segments are written here,
+    * should have room for `count` values
+    * @return size_t number of intersected segments
+    */
+   static size_t intersectAll(const CompactSegment& segment,
+                              const CompactSegment* segments,
+                              size_t count, uint* hits);
+   /**
+    * @brief Checks if there are at least two intersecting segments,
+    * sweep line algorithm (Shamos-Hoey), O(n log n)
+    */
+   static bool isAnyIntersection(
+     const std::vector<CompactSegment>& segments);
+};
+
+#endif // GEOMETRY_LIB_COMPACTSEGMENT_HPP
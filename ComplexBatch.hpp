@@ -0,0 +1,194 @@
+#ifndef GEOMETRY_LIB_COMPLEXBATCH_HPP
+#define GEOMETRY_LIB_COMPLEXBATCH_HPP
+
+#include <array>
+#include <cstddef>
+
+#include "ComplexNumber.hpp"
+#include "Vector2.hpp"
+
+/**
+ * @brief N complex numbers stored as separate arrays of real and
+ * imaginary parts (structure of arrays). Every operation is a plain
+ * loop over the lanes, so compilers turn it into SIMD instructions of
+ * the target.
+ *
+ * Used by fractal kernels and by batch transforms of points. N should
+ * be a multiple of the SIMD width, 8 suits both SSE2 and AVX-512.
+ */
+template<size_t N>
+struct ComplexBatch
+{
+   static_assert(N > 0, "ComplexBatch: lanes count should be positive");
+
+   double re[N];
+   double im[N];
+
+   static constexpr size_t size() { return N; }
+
+   /**
+    * @brief All lanes equal to `value`
+    */
+   static ComplexBatch broadcast(const ComplexNumber& value)
+   {
+      ComplexBatch result;
+      for (size_t i = 0; i < N; ++i) {
+         result.re[i] = value.Re();
+         result.im[i] = value.Im();
+      }
+      return result;
+   }
+   /**
+    * @brief Loads min(count, N) points as x + yi, the rest lanes are
+    * zero
+    */
+   static ComplexBatch load(const Vector2* points, size_t count)
+   {
+      ComplexBatch result = broadcast(ComplexNumber::zero());
+      for (size_t i = 0; i < N && i < count; ++i) {
+         result.re[i] = points[i].x;
+         result.im[i] = points[i].y;
+      }
+      return result;
+   }
+   /**
+    * @brief Stores the first min(count, N) lanes as points
+    */
+   void store(Vector2* points, size_t count) const
+   {
+      for (size_t i = 0; i < N && i < count; ++i)
+         points[i] = { re[i], im[i] };
+   }
+
+   ComplexNumber get(size_t i) const { return { re[i], im[i] }; }
+   void set(size_t i, const ComplexNumber& value)
+   {
+      re[i] = value.Re();
+      im[i] = value.Im();
+   }
+
+   ComplexBatch operator+(const ComplexBatch& b) const
+   {
+      ComplexBatch result;
+      for (size_t i = 0; i < N; ++i) {
+         result.re[i] = re[i] + b.re[i];
+         result.im[i] = im[i] + b.im[i];
+      }
+      return result;
+   }
+   ComplexBatch operator-(const ComplexBatch& b) const
+   {
+      ComplexBatch result;
+      for (size_t i = 0; i < N; ++i) {
+         result.re[i] = re[i] - b.re[i];
+         result.im[i] = im[i] - b.im[i];
+      }
+      return result;
+   }
+   ComplexBatch operator*(const ComplexBatch& b) const
+   {
+      ComplexBatch result;
+      for (size_t i = 0; i < N; ++i) {
+         result.re[i] = re[i] * b.re[i] - im[i] * b.im[i];
+         result.im[i] = re[i] * b.im[i] + im[i] * b.re[i];
+      }
+      return result;
+   }
+   ComplexBatch operator*(const ComplexNumber& b) const
+   {
+      ComplexBatch result;
+      for (size_t i = 0; i < N; ++i) {
+         result.re[i] = re[i] * b.Re() - im[i] * b.Im();
+         result.im[i] = re[i] * b.Im() + im[i] * b.Re();
+      }
+      return result;
+   }
+   ComplexBatch operator*(double b) const
+   {
+      ComplexBatch result;
+      for (size_t i = 0; i < N; ++i) {
+         result.re[i] = re[i] * b;
+         result.im[i] = im[i] * b;
+      }
+      return result;
+   }
+
+   /**
+    * @brief a * b + c in one pass over the lanes; contracted into FMA
+    * instructions where the target has them
+    */
+   static ComplexBatch fma(const ComplexBatch& a, const ComplexBatch& b,
+                           const ComplexBatch& c)
+   {
+      ComplexBatch result;
+      for (size_t i = 0; i < N; ++i) {
+         result.re[i] = a.re[i] * b.re[i] - a.im[i] * b.im[i] + c.re[i];
+         result.im[i] = a.re[i] * b.im[i] + a.im[i] * b.re[i] + c.im[i];
+      }
+      return result;
+   }
+   static ComplexBatch fma(const ComplexBatch& a, const ComplexBatch& b,
+                           const ComplexNumber& c)
+   {
+      ComplexBatch result;
+      for (size_t i = 0; i < N; ++i) {
+         result.re[i] = a.re[i] * b.re[i] - a.im[i] * b.im[i] + c.Re();
+         result.im[i] = a.re[i] * b.im[i] + a.im[i] * b.re[i] + c.Im();
+      }
+      return result;
+   }
+
+   std::array<double, N> Mod2() const
+   {
+      std::array<double, N> result;
+      for (size_t i = 0; i < N; ++i)
+         result[i] = re[i] * re[i] + im[i] * im[i];
+      return result;
+   }
+
+   ComplexBatch conjugate() const
+   {
+      ComplexBatch result;
+      for (size_t i = 0; i < N; ++i) {
+         result.re[i] = re[i];
+         result.im[i] = -im[i];
+      }
+      return result;
+   }
+   /**
+    * @brief 1 / this as the conjugate divided by Mod2: one division per
+    * lane instead of two
+    */
+   ComplexBatch reciprocal() const
+   {
+      ComplexBatch result;
+      for (size_t i = 0; i < N; ++i) {
+         const double inverse = 1 / (re[i] * re[i] + im[i] * im[i]);
+         result.re[i] = re[i] * inverse;
+         result.im[i] = -im[i] * inverse;
+      }
+      return result;
+   }
+   ComplexBatch operator/(const ComplexBatch& b) const
+   {
+      return *this * b.reciprocal();
+   }
+
+   /**
+    * @brief Polynomial value at every lane of z by Horner's scheme
+    *
+    * @param coefficients from the highest power to the constant term
+    * @param count coefficients count, degree + 1
+    */
+   static ComplexBatch horner(const ComplexNumber* coefficients,
+                              size_t count, const ComplexBatch& z)
+   {
+      ComplexBatch result = broadcast(count ? coefficients[0]
+                                            : ComplexNumber::zero());
+      for (size_t k = 1; k < count; ++k)
+         result = fma(result, z, coefficients[k]);
+      return result;
+   }
+};
+
+#endif // GEOMETRY_LIB_COMPLEXBATCH_HPP
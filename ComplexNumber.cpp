@@ -1,5 +1,7 @@
 #include "ComplexNumber.hpp"
+#include "ComplexBatch.hpp"
 #include "Line.hpp"
+#include "Parallel.hpp"
 
 #include "functions.hpp"
 
@@ -12,12 +14,7 @@ ComplexNumber::ComplexNumber(const Point& point)
 }
 
 ComplexNumber::ComplexNumber(double real, double imaginary) :
-  _imaginary(imaginary), _real(real)
-{
-}
-
-ComplexNumber::ComplexNumber(const ComplexNumber& source) :
-  _imaginary(source.Im()), _real(source.Re())
+  _real(real), _imaginary(imaginary)
 {
 }
 
@@ -33,13 +30,6 @@ std::istream& operator>>(std::istream& in, ComplexNumber& number)
    return in;
 }
 
-void ComplexNumber::operator=(const ComplexNumber& b)
-{
-   this->_real = b.Re();
-   this->_imaginary = b.Im();
-   return;
-}
-
 ComplexNumber ComplexNumber::operator+(const ComplexNumber& b) const
 {
    return ComplexNumber(this->Re() + b.Re(), this->Im() + b.Im());
@@ -55,10 +45,11 @@ ComplexNumber ComplexNumber::operator*(const ComplexNumber& b) const
 }
 ComplexNumber ComplexNumber::operator/(const ComplexNumber& b) const
 {
-   double mod2 = b.Mod2();
+   // Product with the conjugate, scaled by one reciprocal
+   const double inverse = 1 / b.Mod2();
    return ComplexNumber(
-     (this->Re() * b.Re() + this->Im() * b.Im()) / mod2,
-     (this->Im() * b.Re() - this->Re() * b.Im()) / mod2);
+     (this->Re() * b.Re() + this->Im() * b.Im()) * inverse,
+     (this->Im() * b.Re() - this->Re() * b.Im()) * inverse);
 }
 
 bool ComplexNumber::operator==(const ComplexNumber& b) const
@@ -80,3 +71,19 @@ ComplexNumber ComplexNumber::round(const ComplexNumber& number, int8_t ulp)
    return ComplexNumber(::round(number._real, ulp),
                         ::round(number._imaginary, 2));
 }
+
+void ComplexNumber::transform(const Vector2* points, size_t count,
+                              const ComplexNumber& factor,
+                              const ComplexNumber& offset,
+                              Vector2* result)
+{
+   using Batch = ComplexBatch<8>;
+   const Batch shift = Batch::broadcast(offset);
+   impl::parallelFor(0, count, 16384, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i += Batch::size()) {
+         const Batch z = Batch::load(points + i, end - i);
+         Batch::fma(z, Batch::broadcast(factor), shift)
+           .store(result + i, end - i);
+      }
+   });
+}
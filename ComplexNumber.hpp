@@ -1,7 +1,10 @@
 #ifndef GEOMETRY_LIB_COMPLEXNUMBER_HPP
 #define GEOMETRY_LIB_COMPLEXNUMBER_HPP
 
+#include "FastAngle.hpp"
 #include "Point.hpp"
+#include "Vector2.hpp"
+#include <cstddef>
 #include <iostream>
 
 // TODO write comments
@@ -9,18 +12,18 @@
 class ComplexNumber
 {
   private:
-   double _imaginary;
    double _real;
+   double _imaginary;
    friend std::ostream& operator<<(std::ostream& out,
                                    const ComplexNumber& number);
    friend std::istream& operator>>(std::istream& in, ComplexNumber& number);
 
   public:
    ComplexNumber(double real = 0, double imaginary = 0);
-   ComplexNumber(const ComplexNumber& source);
+   ComplexNumber(const ComplexNumber& source) = default;
    ComplexNumber(const Point& point);
 
-   void operator=(const ComplexNumber& b);
+   ComplexNumber& operator=(const ComplexNumber& b) = default;
 
    ComplexNumber operator+(const ComplexNumber& b) const;
    ComplexNumber operator-(const ComplexNumber& b) const;
@@ -50,6 +53,22 @@ class ComplexNumber
    const double Mod2() const { return _real * _real + _imaginary * _imaginary; }
 
    static ComplexNumber zero() { return ComplexNumber(0, 0); }
+   /**
+    * @brief Multiplier rotating by `angle` and scaling by `scale`
+    */
+   static ComplexNumber rotation(const FastAngle& angle, double scale = 1)
+   {
+      return ComplexNumber(angle.cos() * scale, angle.sin() * scale);
+   }
+   /**
+    * @brief result[i] = factor * points[i] + offset for points taken as
+    * x + yi: rotation by factor.Arg(), scaling by factor.Mod() and
+    * translation by offset. Computed in parallel with ComplexBatch,
+    * `result` may be `points`.
+    */
+   static void transform(const Vector2* points, size_t count,
+                         const ComplexNumber& factor,
+                         const ComplexNumber& offset, Vector2* result);
 };
 
 #endif // GEOMETRY_LIB_COMPLEXNUMBER_HPP
@@ -1,4 +1,6 @@
 #include "Curve.hpp"
+#include "CurveFlattener.hpp"
+#include "Instrumentation.hpp"
 
 Curve::Curve(const std::vector<Point> points)
 {
@@ -6,57 +8,56 @@ Curve::Curve(const std::vector<Point> points)
 }
 Curve::~Curve() {}
 
-Point multiple(const Point& p, double multiplier)
-{
-   Point result(p.size());
-   for (size_t i = 0; i < p.size(); ++i) {
-      result[i] = p[i] * multiplier;
+namespace impl {
+   std::vector<Point> toPoints(const std::vector<Vector2>& polyline)
+   {
+      std::vector<Point> result;
+      result.reserve(polyline.size());
+      for (auto&& p : polyline)
+         result.push_back(p.toPoint());
+      return result;
    }
-   return result;
-}
+} // namespace impl
 
 Curve Curve::makeBezierCurve(const Point& P0, const Point& P1,
                              const Point& P2)
 {
-   const double step = 0.001;
-   std::vector<Point> result(static_cast<size_t>(1 / step));
-   const Point dP1 = (P1 - P0), dP2 = (P2 - P1);
-   size_t index = 0;
-   for (double i = 0; i < 1; i += step, ++index) {
-      /**
-       * @brief Q0 is on P0P1, Q1 is on P1P2
-       */
-      Point Q0, Q1;
-      Q0 = P0 + multiple(dP1, i);
-      Q1 = P1 + multiple(dP2, i);
-      result[index] = Q0 + multiple(Q1 - Q0, i);
-   }
-   return Curve(result);
+   return makeBezierCurve(std::vector<Point>{ P0, P1, P2 });
 }
 
 Curve Curve::makeBezierCurve(const Point& P0, const Point& P1,
                              const Point& P2, const Point& P3)
 {
-   const double step = 0.001;
-   std::vector<Point> result(static_cast<size_t>(1 / step));
-   const Point dP1 = (P1 - P0), dP2 = (P2 - P1), dP3 = (P3 - P2);
-   size_t index = 0;
-   for (double i = 0; i < 1; i += step, ++index) {
-      /**
-       * @brief Q0 is on P0P1, Q1 is on P1P2, Q2 is on P2P3
-       */
-      Point Q0, Q1, Q2;
-      // Q0 represents P0 for quadratic curve
-      Q0 = P0 + multiple(dP1, i);
-      // Q1 represents P1 for quadratic curve
-      Q1 = P1 + multiple(dP2, i);
-      // Q2 represents P2 for quadratic curve
-      Q2 = P2 + multiple(dP3, i);
-
-      // Store final result in Q0, Q1
-      Q0 = Q0 + multiple(Q1 - Q0, i);
-      Q1 = Q1 + multiple(Q2 - Q1, i);
-      result[index] = Q0 + multiple(Q1 - Q0, i);
-   }
-   return Curve(result);
+   return makeBezierCurve(std::vector<Point>{ P0, P1, P2, P3 });
+}
+
+Curve Curve::makeBezierCurve(const std::vector<Point>& controls,
+                             double tolerance)
+{
+   GEOMETRY_TIMER("Curve::makeBezierCurve");
+   CurveFlattener flattener(tolerance);
+   std::vector<Vector2> polyline;
+   flattener.bezier(controls, polyline);
+   return Curve(impl::toPoints(polyline));
+}
+
+Curve Curve::simplify(double tolerance,
+                      Simplification::Method m) const
+{
+   return Curve(Simplification::simplify(_points, tolerance, m));
+}
+
+Curve Curve::transformed(const Transform& transform) const
+{
+   return Curve(transform.apply(_points));
+}
+
+Curve Curve::makeBSpline(const std::vector<Point>& controls,
+                         size_t degree, double tolerance)
+{
+   GEOMETRY_TIMER("Curve::makeBSpline");
+   CurveFlattener flattener(tolerance);
+   std::vector<Vector2> polyline;
+   flattener.bSpline(controls, degree, polyline);
+   return Curve(impl::toPoints(polyline));
 }
@@ -4,6 +4,8 @@
 #include <vector>
 
 #include "Point.hpp"
+#include "Simplification.hpp"
+#include "Transform.hpp"
 
 class Curve
 {
@@ -40,6 +42,42 @@ class Curve
     */
    static Curve makeBezierCurve(const Point& P0, const Point& P1,
                                 const Point& P2, const Point& P3);
+   /**
+    * @brief Make bézier curve of any degree. Number of points depends
+    * on curvature, not on length of the curve.
+    *
+    * @param controls Control points, at least 2
+    * @param tolerance Maximal distance between the curve and result
+    * points polyline
+    * @return Curve
+    */
+   static Curve makeBezierCurve(const std::vector<Point>& controls,
+                                double tolerance = 0.001);
+   /**
+    * @brief Make clamped uniform B-spline curve
+    *
+    * @param controls Control points, at least degree + 1
+    * @param degree Degree of the spline
+    * @param tolerance Maximal distance between the curve and result
+    * points polyline
+    * @return Curve
+    */
+   /**
+    * @brief Simplified copy of `this` Curve, ends are kept
+    *
+    * @param tolerance distance for DOUGLAS_PEUCKER, area for
+    * VISVALINGAM_WHYATT (see Simplification.hpp)
+    * @return Curve
+    */
+   Curve simplify(double tolerance, Simplification::Method m) const;
+   /**
+    * @brief Image of `this` Curve under `transform` (see Transform.hpp)
+    */
+   Curve transformed(const Transform& transform) const;
+
+   static Curve makeBSpline(const std::vector<Point>& controls,
+                            size_t degree = 3,
+                            double tolerance = 0.001);
 };
 
 #endif // GEOMETRY_LIB_CURVE_HPP
@@ -0,0 +1,205 @@
+#include "CurveFlattener.hpp"
+#include "Instrumentation.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+CurveFlattener::CurveFlattener(double tolerance)
+{
+   setTolerance(tolerance);
+}
+
+void CurveFlattener::setTolerance(double tolerance)
+{
+   if (!(tolerance > 0))
+      throw std::invalid_argument(
+        "CurveFlattener: tolerance should be positive");
+   _tolerance = tolerance;
+}
+
+bool CurveFlattener::isFlat(const Vector2* controls, size_t count) const
+{
+   const Vector2 &begin = controls[0], &end = controls[count - 1];
+   const Vector2 chord = end - begin;
+   const double length2 = chord * chord,
+                tolerance2 = _tolerance * _tolerance;
+   for (size_t i = 1; i + 1 < count; ++i) {
+      const Vector2 d = controls[i] - begin;
+      // Distance to the chord segment, not to the line: the control
+      // polygon may go back along the chord
+      double t = (length2 > 0) ? (d * chord) / length2 : 0;
+      t = std::min(1.0, std::max(0.0, t));
+      const Vector2 deviation = d - chord * t;
+      if (deviation * deviation > tolerance2)
+         return false;
+   }
+   return true;
+}
+
+void CurveFlattener::split(Vector2* controls, size_t count,
+                           Vector2* left, Vector2* right)
+{
+   const size_t n = count - 1;
+   left[0] = controls[0];
+   right[n] = controls[n];
+   for (size_t level = 1; level <= n; ++level) {
+      for (size_t i = 0; i + level <= n; ++i)
+         controls[i] = (controls[i] + controls[i + 1]) * 0.5;
+      left[level] = controls[0];
+      right[n - level] = controls[n - level];
+   }
+}
+
+void CurveFlattener::flattenSegment(const Vector2* controls,
+                                    size_t count,
+                                    std::vector<Vector2>& out)
+{
+   _stack.assign(controls, controls + count);
+   _depths.assign(1, 0);
+   while (!_depths.empty()) {
+      const size_t base = _stack.size() - count;
+      const uint8_t depth = _depths.back();
+      if (depth >= maxDepth || isFlat(&_stack[base], count)) {
+         out.push_back(_stack[base + count - 1]);
+         _stack.resize(base);
+         _depths.pop_back();
+         continue;
+      }
+      _triangle.assign(_stack.begin() + base, _stack.end());
+      _stack.resize(base + 2 * count);
+      // Left half goes on top of the stack, it is processed first
+      split(_triangle.data(),
+            count,
+            &_stack[base + count],
+            &_stack[base]);
+      _depths.back() = depth + 1;
+      _depths.push_back(depth + 1);
+   }
+}
+
+void CurveFlattener::bezier(const Vector2* controls, size_t count,
+                            std::vector<Vector2>& out)
+{
+   if (count < 2)
+      throw std::invalid_argument(
+        "CurveFlattener: Bézier curve needs at least 2 points");
+   out.push_back(controls[0]);
+   flattenSegment(controls, count, out);
+}
+
+void CurveFlattener::bezier(const std::vector<Point>& controls,
+                            std::vector<Vector2>& out)
+{
+   _controls.resize(controls.size());
+   for (size_t i = 0; i < controls.size(); ++i)
+      _controls[i] = Vector2::from(controls[i]);
+   bezier(_controls.data(), _controls.size(), out);
+}
+
+void CurveFlattener::bSpline(const Vector2* controls, size_t count,
+                             size_t degree, std::vector<Vector2>& out)
+{
+   if (degree < 1 || count < degree + 1)
+      throw std::invalid_argument(
+        "CurveFlattener: B-spline of degree p needs at least p + 1 "
+        "points");
+
+   const size_t n = count - 1, p = degree, m = n + p + 1;
+   // Clamped uniform knot vector
+   _knots.resize(m + 1);
+   for (size_t i = 0; i <= m; ++i)
+      _knots[i] = (i <= p) ? 0
+                           : ((i > n) ? static_cast<double>(n - p + 1)
+                                      : static_cast<double>(i - p));
+
+   // Decompose into Bézier segments (Piegl & Tiller, The NURBS Book,
+   // algorithm A5.6)
+   const size_t order = p + 1;
+   _segments.resize((n - p + 1) * order);
+   _alphas.resize(p);
+   Vector2* q = _segments.data();
+   size_t a = p, b = p + 1, segments = 0;
+   for (size_t i = 0; i <= p; ++i)
+      q[i] = controls[i];
+   while (b < m) {
+      const size_t i = b;
+      while (b < m && _knots[b + 1] == _knots[b])
+         ++b;
+      const size_t multiplicity = b - i + 1;
+      if (multiplicity < p) {
+         const double numerator = _knots[b] - _knots[a];
+         for (size_t j = p; j > multiplicity; --j)
+            _alphas[j - multiplicity - 1] =
+              numerator / (_knots[a + j] - _knots[a]);
+         const size_t r = p - multiplicity;
+         for (size_t j = 1; j <= r; ++j) {
+            const size_t save = r - j, s = multiplicity + j;
+            Vector2* current = q + segments * order;
+            for (size_t k = p; k >= s; --k) {
+               const double alpha = _alphas[k - s];
+               current[k] =
+                 current[k] * alpha + current[k - 1] * (1.0 - alpha);
+            }
+            if (b < m)
+               current[order + save] = current[p];
+         }
+      }
+      ++segments;
+      if (b < m) {
+         for (size_t j = p - multiplicity; j <= p; ++j)
+            q[segments * order + j] = controls[b - p + j];
+         a = b;
+         ++b;
+      }
+   }
+
+   out.push_back(q[0]);
+   for (size_t s = 0; s < segments; ++s)
+      flattenSegment(q + s * order, order, out);
+}
+
+void CurveFlattener::bSpline(const std::vector<Point>& controls,
+                             size_t degree, std::vector<Vector2>& out)
+{
+   std::vector<Vector2> converted(controls.size());
+   for (size_t i = 0; i < controls.size(); ++i)
+      converted[i] = Vector2::from(controls[i]);
+   bSpline(converted.data(), converted.size(), degree, out);
+}
+
+void CurveFlattener::bezierBatch(const std::vector<Vector2>& controls,
+                                 const std::vector<size_t>& offsets,
+                                 double tolerance,
+                                 std::vector<Vector2>& out,
+                                 std::vector<size_t>& out_offsets)
+{
+   GEOMETRY_TIMER("CurveFlattener::bezierBatch");
+   const size_t curves = offsets.empty() ? 0 : offsets.size() - 1;
+   // Polyline points and sizes of each chunk, merged in chunk order
+   std::vector<std::vector<Vector2>> points(
+     impl::chunksCount(curves, 64));
+   std::vector<std::vector<size_t>> sizes(points.size());
+
+   impl::parallelChunks(
+     curves, 64, [&](size_t chunk, size_t begin, size_t end) {
+        CurveFlattener flattener(tolerance);
+        sizes[chunk].reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+           const size_t before = points[chunk].size();
+           flattener.bezier(controls.data() + offsets[i],
+                            offsets[i + 1] - offsets[i],
+                            points[chunk]);
+           sizes[chunk].push_back(points[chunk].size() - before);
+        }
+     });
+
+   out.clear();
+   out_offsets.assign(1, 0);
+   out_offsets.reserve(curves + 1);
+   for (size_t chunk = 0; chunk < points.size(); ++chunk) {
+      out.insert(out.end(), points[chunk].begin(), points[chunk].end());
+      for (size_t size : sizes[chunk])
+         out_offsets.push_back(out_offsets.back() + size);
+   }
+}
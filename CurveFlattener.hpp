@@ -0,0 +1,104 @@
+#ifndef GEOMETRY_LIB_CURVEFLATTENER_HPP
+#define GEOMETRY_LIB_CURVEFLATTENER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "Point.hpp"
+#include "Vector2.hpp"
+
+/**
+ * @brief Converts Bézier curves and B-splines of any degree to
+ * polylines by adaptive de Casteljau subdivision: a part of the curve
+ * is split in halves until its control polygon is closer than the
+ * tolerance to its chord.
+ *
+ * The object keeps its work buffers between calls, and results are
+ * appended to buffers passed by caller, so repeated flattening does
+ * not allocate after warm-up.
+ */
+class CurveFlattener
+{
+  private:
+   double _tolerance;
+   /**
+    * @brief Stack of control polygons waiting for subdivision
+    */
+   std::vector<Vector2> _stack;
+   std::vector<uint8_t> _depths;
+   /**
+    * @brief de Casteljau triangle for a split
+    */
+   std::vector<Vector2> _triangle;
+   std::vector<Vector2> _controls;
+   std::vector<double> _knots;
+   std::vector<Vector2> _segments;
+   std::vector<double> _alphas;
+
+   bool isFlat(const Vector2* controls, size_t count) const;
+   /**
+    * @brief Split Bézier curve at t = 0.5, `controls` are used as
+    * scratch
+    */
+   static void split(Vector2* controls, size_t count, Vector2* left,
+                     Vector2* right);
+   /**
+    * @brief Flatten single Bézier segment, its first point is not
+    * appended
+    */
+   void flattenSegment(const Vector2* controls, size_t count,
+                       std::vector<Vector2>& out);
+
+  public:
+   /**
+    * @brief Maximal subdivision depth, limits output to 2^depth
+    * points per segment
+    */
+   static const uint8_t maxDepth = 24;
+
+   /**
+    * @param tolerance maximal distance between the curve and the
+    * polyline (chordal tolerance). Should be positive.
+    */
+   CurveFlattener(double tolerance = 0.001);
+
+   double tolerance() const { return _tolerance; }
+   void setTolerance(double tolerance);
+
+   /**
+    * @brief Flatten Bézier curve of degree count - 1
+    *
+    * @param controls control points, at least 2
+    * @param out the polyline is appended here
+    */
+   void bezier(const Vector2* controls, size_t count,
+               std::vector<Vector2>& out);
+   void bezier(const std::vector<Point>& controls,
+               std::vector<Vector2>& out);
+   /**
+    * @brief Flatten clamped uniform B-spline. The spline is
+    * decomposed into Bézier segments by knot insertion.
+    *
+    * @param controls control points, at least degree + 1
+    * @param degree degree of the spline, at least 1
+    * @param out the polyline is appended here
+    */
+   void bSpline(const Vector2* controls, size_t count, size_t degree,
+                std::vector<Vector2>& out);
+   void bSpline(const std::vector<Point>& controls, size_t degree,
+                std::vector<Vector2>& out);
+
+   /**
+    * @brief Flatten many Bézier curves in parallel. Curve `i` has
+    * control points controls[offsets[i]] .. controls[offsets[i+1]-1].
+    *
+    * @param out_offsets polyline `i` is out[out_offsets[i]] ..
+    * out[out_offsets[i+1]-1]. Polylines are in order of curves.
+    */
+   static void bezierBatch(const std::vector<Vector2>& controls,
+                           const std::vector<size_t>& offsets,
+                           double tolerance, std::vector<Vector2>& out,
+                           std::vector<size_t>& out_offsets);
+};
+
+#endif // GEOMETRY_LIB_CURVEFLATTENER_HPP
@@ -0,0 +1,11 @@
+#include "FastAngle.hpp"
+
+#include <stdexcept>
+#include <string>
+
+void FastAngle::throwOutOfRange(double degrees)
+{
+   throw std::runtime_error(
+     "Cannot construct Angle by incorrect degrees value (" +
+     std::to_string(degrees) + ")");
+}
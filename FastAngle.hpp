@@ -0,0 +1,155 @@
+#ifndef GEOMETRY_LIB_FASTANGLE_HPP
+#define GEOMETRY_LIB_FASTANGLE_HPP
+
+#include <cmath>
+
+#include "Angle.hpp"
+#include "Vector2.hpp"
+
+/**
+ * @brief Unchecked angle normalised to [0, 2pi) with cached cosine and
+ * sine. Sums and differences wrap around and use angle addition
+ * formulas, so they need no trigonometry and never throw.
+ *
+ * Angle validates its range on every construction; FastAngle is for
+ * internal loops, checked() is its validating constructor.
+ */
+class FastAngle
+{
+  private:
+   double _radians = 0, _cos = 1, _sin = 0;
+
+   FastAngle(double radians, double cos, double sin) :
+     _radians(radians),
+     _cos(cos),
+     _sin(sin)
+   {
+   }
+   static double normalise(double radians)
+   {
+      if (radians >= 0 && radians < 2 * M_PI)
+         return radians;
+      radians = std::fmod(radians, 2 * M_PI);
+      if (radians < 0)
+         radians += 2 * M_PI;
+      // fmod of a tiny negative value rounds up to 2pi
+      return (radians < 2 * M_PI) ? radians : 0;
+   }
+   /**
+    * @brief Normalise a sum or a difference of normalised angles
+    */
+   static double wrap(double radians)
+   {
+      if (radians < 0)
+         radians += 2 * M_PI;
+      else if (radians >= 2 * M_PI)
+         radians -= 2 * M_PI;
+      return (radians < 2 * M_PI) ? radians : 0;
+   }
+
+  public:
+   FastAngle() = default;
+
+   static FastAngle fromRadians(double radians)
+   {
+      radians = normalise(radians);
+      return { radians, std::cos(radians), std::sin(radians) };
+   }
+   static FastAngle fromDegrees(double degrees)
+   {
+      return fromRadians(degrees * (M_PI / 180));
+   }
+   /**
+    * @brief Angle of the direction v (not zero) from the x axis.
+    * Cosine and sine are taken from v itself.
+    */
+   static FastAngle fromVector(const Vector2& v)
+   {
+      const double length = std::hypot(v.x, v.y);
+      return { normalise(std::atan2(v.y, v.x)),
+               v.x / length,
+               v.y / length };
+   }
+   static FastAngle from(const Angle& a)
+   {
+      return fromDegrees(a.degrees());
+   }
+   /**
+    * @brief Checked constructor: throws std::runtime_error if degrees
+    * are not in [min, max]
+    */
+   static FastAngle checked(double degrees, double min = -360,
+                            double max = 360)
+   {
+      return fromDegrees(checkDegrees(degrees, min, max));
+   }
+   /**
+    * @brief Returns degrees if they are in [min, max], otherwise
+    * throws std::runtime_error
+    */
+   static double checkDegrees(double degrees, double min, double max)
+   {
+      if (min <= degrees && degrees <= max && !std::isinf(degrees))
+         return degrees;
+      throwOutOfRange(degrees);
+   }
+   [[noreturn]] static void throwOutOfRange(double degrees);
+
+   double radians() const { return _radians; }
+   double degrees() const { return _radians * (180 / M_PI); }
+   double cos() const { return _cos; }
+   double sin() const { return _sin; }
+   /**
+    * @brief Unit vector of `this` direction
+    */
+   Vector2 unit() const { return { _cos, _sin }; }
+   /**
+    * @brief Checked conversion, degrees in [0, 360)
+    */
+   Angle toAngle() const { return Angle(degrees(), Angle::Positive); }
+
+   FastAngle operator+(const FastAngle& other) const
+   {
+      return { wrap(_radians + other._radians),
+               _cos * other._cos - _sin * other._sin,
+               _sin * other._cos + _cos * other._sin };
+   }
+   FastAngle operator-(const FastAngle& other) const
+   {
+      return { wrap(_radians - other._radians),
+               _cos * other._cos + _sin * other._sin,
+               _sin * other._cos - _cos * other._sin };
+   }
+   FastAngle operator-() const { return FastAngle() - *this; }
+   /**
+    * @brief Scaled angle, wraps around
+    */
+   FastAngle operator*(double multiplier) const
+   {
+      return fromRadians(_radians * multiplier);
+   }
+
+   bool operator==(const FastAngle& other) const
+   {
+      return _radians == other._radians;
+   }
+   bool operator!=(const FastAngle& other) const
+   {
+      return !(*this == other);
+   }
+   bool operator<(const FastAngle& other) const
+   {
+      return _radians < other._radians;
+   }
+   bool operator>(const FastAngle& other) const { return other < *this; }
+   bool operator<=(const FastAngle& other) const
+   {
+      return !(other < *this);
+   }
+   bool operator>=(const FastAngle& other) const
+   {
+      return !(*this < other);
+   }
+};
+
+#endif // GEOMETRY_LIB_FASTANGLE_HPP
@@ -1,5 +1,8 @@
 #include "Fractals.hpp"
 #include "Circle.hpp"
+#include "FastAngle.hpp"
+#include "Instrumentation.hpp"
+#include "Parallel.hpp"
 #include "Polygon.hpp"
 #include <array>
 #include <cmath>
@@ -45,11 +48,10 @@ RGB HSVtoRGB(const HSV& c)
    return ans;
 }
 
-RGB Fractals::newColorMandelbrot(const ComplexNumber& cn,
-                                 int max_iterations)
+RGB Fractals::newColorMandelbrot(int iterations, int max_iterations)
 {
-   ComplexNumber z = cn;
-   int iterations = numIterationsMandelbrot(z, max_iterations);
+   GEOMETRY_COUNT(ESCAPE_ITERATIONS,
+                  iterations < 0 ? max_iterations : iterations);
 
    if (iterations == -1)
       return RGB(0, 0, 0);
@@ -61,54 +63,67 @@ RGB Fractals::newColorMandelbrot(const ComplexNumber& cn,
      HSV(t, 80, 100 * (0.5 + atan(n * a - c * n) / M_PI)));
 }
 
-int Fractals::numIterationsMandelbrot(ComplexNumber& z,
-                                      int max_iterations)
+void Fractals::numIterationsMandelbrot(const Batch& c, int max_iterations,
+                                       int* iterations)
 {
-   double mod2;
-   const double barrier = 4;
-   ComplexNumber c(z);
-   mod2 = c.Mod2();
-   if (mod2 < barrier || isZero(mod2 - barrier))
-      z = c;
-   else
-      return 0;
-   for (int i = 1; i <= max_iterations; i++) {
-      mod2 = z.Mod2();
-      if (mod2 < barrier || isZero(mod2 - barrier))
-         z = z * z + c;
-      else
-         return i;
+   // |z|^2 <= barrier within eps
+   const double barrier = 4 + eps;
+   bool escaped[lanes];
+   size_t active = lanes;
+   for (size_t k = 0; k < lanes; ++k) {
+      escaped[k] = false;
+      iterations[k] = -1;
+   }
+   // z_0 = c escaping gives 0, z_m escaping gives m + 1, as the
+   // check of c goes before the first iteration. Lanes keep iterating
+   // after they escape, only the first escape is recorded.
+   const int checks = std::max(max_iterations, 1);
+   Batch z = c;
+   for (int m = 0; m < checks && active; m++) {
+      const std::array<double, lanes> mod2 = z.Mod2();
+      for (size_t k = 0; k < lanes; ++k)
+         if (!escaped[k] && !(mod2[k] <= barrier)) {
+            escaped[k] = true;
+            iterations[k] = (m == 0) ? 0 : m + 1;
+            --active;
+         }
+      z = Batch::fma(z, z, c);
    }
-   return -1;
 }
 
 std::vector<std::vector<RGB>> Fractals::mandelbrotSet(
   const Point& p, int width_px, int height_px, double width,
   double height, int max_iterations)
 {
-   int i, j;
+   GEOMETRY_TIMER("Fractals::mandelbrotSet");
    std::vector<std::vector<RGB>> ans(height_px);
-   for (i = 0; i < height_px; i++)
+   for (int i = 0; i < height_px; i++)
       ans[i] = std::vector<RGB>(width_px);
 
    double h = width / width_px;
-   ComplexNumber cn(p);
-
-   for (i = 0; i < height_px; i++) {
-      cn = cn - ComplexNumber(0, h);
-      for (j = 0; j < width_px; j++) {
-         ans[i][j] = newColorMandelbrot(cn + ComplexNumber(j * h, 0),
-                                        max_iterations);
+   const ComplexNumber cn(p);
+
+   // Rows are independent, row value is computed directly so it does
+   // not depend on the order rows are rendered in. Pixels of a row go
+   // in batches of `lanes`.
+   impl::parallelFor(0, height_px, 8, [&](size_t begin, size_t end) {
+      int iterations[lanes];
+      for (size_t i = begin; i < end; i++) {
+         const ComplexNumber row = cn - ComplexNumber(0, (i + 1) * h);
+         for (int j = 0; j < width_px; j += lanes) {
+            const Batch c = rowBatch(row, j, h);
+            numIterationsMandelbrot(c, max_iterations, iterations);
+            for (int k = 0; k < (int)lanes && j + k < width_px; k++)
+               ans[i][j + k] =
+                 newColorMandelbrot(iterations[k], max_iterations);
+         }
       }
-   }
+   });
    return ans;
 }
 
-RGB Fractals::newColorNewton(const ComplexNumber& cn)
+RGB Fractals::newColorNewton(const ComplexNumber& z, int iterations)
 {
-   ComplexNumber z = cn;
-   int iterations = numIterationsNewton(z);
-
    if (iterations == -1)
       return RGB(0, 0, 0);
    float a;
@@ -122,28 +137,43 @@ RGB Fractals::newColorNewton(const ComplexNumber& cn)
      HSV(t, 80, 5 + 100 * (0.5 + atan(n * a - c * n) / M_PI)));
 }
 
-int Fractals::numIterationsNewton(ComplexNumber& z)
+void Fractals::numIterationsNewton(Batch& z, int* iterations)
 {
-   double mod2 = 1;
    const double max = 1e+10, min = 1e-10;
-   ComplexNumber z_prev(z);
-   bool c = true;
-   int i;
-
-   for (i = -1; c; i++) {
-      if (mod2 < min)
-         c = false;
-      else if (mod2 > max) {
-         c = false;
-         i = -2;
-      } else {
-         z_prev = z;
-         z = z - (z * z * z + ComplexNumber(1, 0)) /
-                   (ComplexNumber(3, 0) * z * z);
-         mod2 = (z - z_prev).Mod2();
+   // Newton's method for z^3 + 1 = 0
+   static const ComplexNumber polynomial[] = { 1, 0, 0, 1 };
+   static const ComplexNumber derivative[] = { 3, 0, 0 };
+   bool done[lanes];
+   size_t active = lanes;
+   for (size_t k = 0; k < lanes; ++k) {
+      done[k] = false;
+      iterations[k] = 0;
+   }
+   while (active) {
+      const Batch next =
+        z - Batch::horner(polynomial, 4, z) /
+              Batch::horner(derivative, 3, z);
+      const std::array<double, lanes> mod2 = (next - z).Mod2();
+      for (size_t k = 0; k < lanes; ++k) {
+         if (done[k])
+            continue;
+         GEOMETRY_COUNT(ESCAPE_ITERATIONS, 1);
+         z.re[k] = next.re[k];
+         z.im[k] = next.im[k];
+         ++iterations[k];
+         if (mod2[k] < min) {
+            done[k] = true;
+            --active;
+         }
+         // NaN (a.e. z = 0 step) is treated as divergence, otherwise
+         // the loop never ends
+         else if (!(mod2[k] <= max)) {
+            done[k] = true;
+            iterations[k] = -1;
+            --active;
+         }
       }
    }
-   return i;
 }
 
 std::vector<std::vector<RGB>> Fractals::NewtonFractal(const Point& p,
@@ -152,25 +182,46 @@ std::vector<std::vector<RGB>> Fractals::NewtonFractal(const Point& p,
                                                       double width,
                                                       double height)
 {
-   int i, j;
+   GEOMETRY_TIMER("Fractals::NewtonFractal");
    std::vector<std::vector<RGB>> ans(height_px);
-   for (i = 0; i < height_px; i++)
+   for (int i = 0; i < height_px; i++)
       ans[i] = std::vector<RGB>(width_px);
 
    double h = width / width_px;
-   ComplexNumber cn(p);
-
-   for (i = 0; i < height_px; i++) {
-      cn = cn - ComplexNumber(0, h);
-      for (j = 0; j < width_px; j++) {
-         ans[i][j] = newColorNewton(cn + ComplexNumber(j * h, 0));
+   const ComplexNumber cn(p);
+
+   // Rows are independent, row value is computed directly so it does
+   // not depend on the order rows are rendered in. Pixels of a row go
+   // in batches of `lanes`.
+   impl::parallelFor(0, height_px, 8, [&](size_t begin, size_t end) {
+      int iterations[lanes];
+      for (size_t i = begin; i < end; i++) {
+         const ComplexNumber row = cn - ComplexNumber(0, (i + 1) * h);
+         for (int j = 0; j < width_px; j += lanes) {
+            Batch z = rowBatch(row, j, h);
+            numIterationsNewton(z, iterations);
+            for (int k = 0; k < (int)lanes && j + k < width_px; k++)
+               ans[i][j + k] = newColorNewton(z.get(k), iterations[k]);
+         }
       }
-   }
+   });
    return ans;
 }
 
+Fractals::Batch Fractals::rowBatch(const ComplexNumber& row, int column,
+                                   double step)
+{
+   Batch result;
+   for (size_t k = 0; k < lanes; ++k) {
+      result.re[k] = row.Re() + (column + (int)k) * step;
+      result.im[k] = row.Im();
+   }
+   return result;
+}
+
 std::vector<std::vector<RGB>> Fractals::plasmaFractal(int n)
 {
+   GEOMETRY_TIMER("Fractals::plasmaFractal");
    int i, size = (int)(pow(2, n) + 0.1) + 1;
    std::vector<std::vector<RGB>> ans(size);
    for (i = 0; i < size; i++)
@@ -183,12 +234,15 @@ std::vector<std::vector<RGB>> Fractals::plasmaFractal(int n)
    heights[size - 1][0] = getRandNum(1);
    heights[size - 1][size - 1] = getRandNum(1);
 
+   // Heights use rand(), so only the coloring is parallel
    heightsPlasma(heights);
-   for (i = 0; i < size; i++)
-      std::transform(heights[i].begin(),
-                     heights[i].end(),
-                     ans[i].begin(),
-                     [](double a) { return heightToRGB(a); });
+   impl::parallelFor(0, size, 16, [&](size_t begin, size_t end) {
+      for (size_t row = begin; row < end; row++)
+         std::transform(heights[row].begin(),
+                        heights[row].end(),
+                        ans[row].begin(),
+                        [](double a) { return heightToRGB(a); });
+   });
    return ans;
 }
 
@@ -239,10 +293,11 @@ std::list<Point> equaliteralTriangleByCenter(const Point& center,
    std::list<Point> result;
    const double radius = (sqrt(3) / 3) * side;
    Circle circle(center, radius);
-   const Angle start(90);
+   const FastAngle start = FastAngle::fromDegrees(90),
+                   step = FastAngle::fromDegrees(120);
    result.push_back(circle.getPoint(start));
-   result.insert(result.begin(), circle.getPoint(start + 120));
-   result.push_back(circle.getPoint(Angle(start - 120)));
+   result.insert(result.begin(), circle.getPoint(start + step));
+   result.push_back(circle.getPoint(start - step));
    return result;
 }
 
@@ -444,6 +499,7 @@ std::vector<Point> Fractals::geometricFractal(const Point& p,
                                               const Area& area,
                                               GeometricFractalType t)
 {
+   GEOMETRY_TIMER("Fractals::geometricFractal");
    switch (t) {
       case GeometricFractalType::KOCH_SNOWFLAKE:
          return fractalCochSnowflake(p, area);
@@ -490,6 +546,7 @@ double Fractals::getRandNum(int iter)
 
 std::vector<std::vector<RGB>> Fractals::brokenPlasmaFractal(int n)
 {
+   GEOMETRY_TIMER("Fractals::brokenPlasmaFractal");
    int i, size = (int)(pow(2, n) + 0.1) + 1;
    std::vector<std::vector<RGB>> ans(size);
    for (i = 0; i < size; i++)
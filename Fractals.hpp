@@ -7,6 +7,7 @@
 #include <iostream>
 #include <vector>
 
+#include "ComplexBatch.hpp"
 #include "ComplexNumber.hpp"
 #include "Point.hpp"
 #include "functions.hpp"
@@ -61,13 +62,33 @@ const double _persistence = 1.5;
 class Fractals
 {
   private:
-   static RGB newColorMandelbrot(const ComplexNumber& cn,
-                                 int max_iterations);
-   static int numIterationsMandelbrot(ComplexNumber& z,
-                                      int max_iterations);
+   /**
+    * @brief Pixels computed together by Mandelbrot and Newton kernels
+    */
+   static constexpr size_t lanes = 8;
+   using Batch = ComplexBatch<lanes>;
+
+   /**
+    * @brief Pixels from `column` of the row starting at `row` with
+    * `step` between pixels
+    */
+   static Batch rowBatch(const ComplexNumber& row, int column,
+                         double step);
 
-   static RGB newColorNewton(const ComplexNumber& cn);
-   static int numIterationsNewton(ComplexNumber& z);
+   static RGB newColorMandelbrot(int iterations, int max_iterations);
+   /**
+    * @brief Escape iterations of every lane of c, -1 for points of the
+    * set
+    */
+   static void numIterationsMandelbrot(const Batch& c, int max_iterations,
+                                       int* iterations);
+
+   static RGB newColorNewton(const ComplexNumber& z, int iterations);
+   /**
+    * @brief Iterates every lane of z until it converges (iterations
+    * count is stored) or diverges (-1 is stored)
+    */
+   static void numIterationsNewton(Batch& z, int* iterations);
 
    static void heightsPlasma(
      std::vector<std::vector<double>>& heights);
@@ -0,0 +1,81 @@
+#include "GeometryBatch.hpp"
+
+#include <stdexcept>
+
+void GeometryBatch::clear()
+{
+   truncate(0);
+}
+
+void GeometryBatch::truncate(size_t count)
+{
+   if (count > size())
+      return;
+   types.resize(count);
+   geometries.resize(count + 1);
+   parts.resize(geometries.back() + 1);
+   rings.resize(parts.back() + 1);
+   x.resize(rings.back());
+   y.resize(rings.back());
+}
+
+void GeometryBatch::addPoint(const Vector2& point)
+{
+   addCoordinate(point.x, point.y);
+   closeRing();
+   closePart();
+   closeGeometry(POINT);
+}
+
+void GeometryBatch::addLineString(const Vector2* points, size_t count)
+{
+   for (size_t i = 0; i < count; ++i)
+      addCoordinate(points[i].x, points[i].y);
+   closeRing();
+   closePart();
+   closeGeometry(LINESTRING);
+}
+
+void GeometryBatch::addPolygon(const Polygon& polygon)
+{
+   const std::vector<Point> points = polygon.get();
+   for (auto&& p : points)
+      addCoordinate(p[0], p[1]);
+   if (!points.empty())
+      addCoordinate(points[0][0], points[0][1]);
+   closeRing();
+   closePart();
+   closeGeometry(POLYGON);
+}
+
+Polygon GeometryBatch::polygon(size_t part) const
+{
+   if (part + 1 >= parts.size() || parts[part] == parts[part + 1])
+      throw std::invalid_argument("GeometryBatch: part has no rings");
+   const size_t ring = parts[part];
+   size_t begin = rings[ring], end = rings[ring + 1];
+   if (end - begin > 1 && x[begin] == x[end - 1] &&
+       y[begin] == y[end - 1])
+      --end;
+   std::vector<Point> points;
+   points.reserve(end - begin);
+   for (size_t i = begin; i < end; ++i)
+      points.emplace_back(x[i], y[i]);
+   return Polygon(points);
+}
+
+std::vector<CompactSegment> GeometryBatch::segments() const
+{
+   std::vector<CompactSegment> result;
+   for (size_t g = 0; g < size(); ++g) {
+      if (partType(types[g]) == POINT)
+         continue;
+      const size_t first_ring = parts[geometries[g]],
+                   last_ring = parts[geometries[g + 1]];
+      for (size_t r = first_ring; r < last_ring; ++r)
+         for (size_t i = rings[r] + 1; i < rings[r + 1]; ++i)
+            result.push_back(
+              CompactSegment::make(coordinate(i - 1), coordinate(i)));
+   }
+   return result;
+}
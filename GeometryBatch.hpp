@@ -0,0 +1,102 @@
+#ifndef GEOMETRY_LIB_GEOMETRYBATCH_HPP
+#define GEOMETRY_LIB_GEOMETRYBATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CompactSegment.hpp"
+#include "Polygon.hpp"
+#include "Vector2.hpp"
+
+/**
+ * @brief Points, line strings, polygons and their MULTI* collections
+ * in structure of arrays form, as read from and written to WKT, WKB
+ * and GeoJSON (see GeometryFormats.hpp).
+ *
+ * Coordinates are kept in `x` and `y`. Three offset arrays, each
+ * starting with 0, group them:
+ * - ring r is coordinates [rings[r], rings[r + 1]);
+ * - part p is rings [parts[p], parts[p + 1]);
+ * - geometry g is parts [geometries[g], geometries[g + 1]).
+ *
+ * A part is a point (one ring of one coordinate), a line string (one
+ * ring) or a polygon (the outer ring, then holes). Single geometries
+ * have one part, EMPTY ones have none.
+ */
+struct GeometryBatch
+{
+   /**
+    * @brief WKB type codes
+    */
+   enum Type : uint8_t
+   {
+      POINT = 1,
+      LINESTRING = 2,
+      POLYGON = 3,
+      MULTIPOINT = 4,
+      MULTILINESTRING = 5,
+      MULTIPOLYGON = 6
+   };
+
+   std::vector<double> x, y;
+   std::vector<size_t> rings = { 0 };
+   std::vector<size_t> parts = { 0 };
+   std::vector<size_t> geometries = { 0 };
+   std::vector<Type> types;
+
+   size_t size() const { return types.size(); }
+   bool empty() const { return types.empty(); }
+   void clear();
+   /**
+    * @brief Keeps the first `count` geometries, drops everything after
+    * them (including an unfinished geometry)
+    */
+   void truncate(size_t count);
+
+   /**
+    * @brief Type of parts of a geometry of type `type`: POINT,
+    * LINESTRING or POLYGON
+    */
+   static Type partType(Type type) { return Type((type - 1) % 3 + 1); }
+   static bool isMulti(Type type) { return type >= MULTIPOINT; }
+
+   /**
+    * @brief Builder used by readers: coordinates are added one by one,
+    * then the ring, the part and the geometry they belong to are closed
+    */
+   void addCoordinate(double x_value, double y_value)
+   {
+      x.push_back(x_value);
+      y.push_back(y_value);
+   }
+   void closeRing() { rings.push_back(x.size()); }
+   void closePart() { parts.push_back(rings.size() - 1); }
+   void closeGeometry(Type type)
+   {
+      types.push_back(type);
+      geometries.push_back(parts.size() - 1);
+   }
+
+   void addPoint(const Vector2& point);
+   void addLineString(const Vector2* points, size_t count);
+   /**
+    * @brief Adds POLYGON with the outer ring only. WKT and GeoJSON
+    * rings are closed, so the first point is repeated at the end.
+    */
+   void addPolygon(const Polygon& polygon);
+
+   Vector2 coordinate(size_t index) const { return { x[index], y[index] }; }
+   /**
+    * @brief Outer ring of polygon part `part` without the closing
+    * point
+    */
+   Polygon polygon(size_t part) const;
+   /**
+    * @brief Segments of all line strings and polygon rings, for
+    * intersection kernels
+    */
+   std::vector<CompactSegment> segments() const;
+};
+
+#endif // GEOMETRY_LIB_GEOMETRYBATCH_HPP
@@ -0,0 +1,305 @@
+#include "GeometryFile.hpp"
+#include "Instrumentation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+static_assert(sizeof(GeometryFile::Header) == 32,
+              "GeometryFile: header should have no padding");
+static_assert(sizeof(Vector2) == 2 * sizeof(double) &&
+                std::is_trivially_copyable<Vector2>::value,
+              "GeometryFile: points are read in place as Vector2");
+static_assert(sizeof(CompactSegment) == 8 * sizeof(double) &&
+                std::is_trivially_copyable<CompactSegment>::value,
+              "GeometryFile: segments are read in place");
+static_assert(sizeof(uint) == sizeof(uint32_t),
+              "GeometryFile: graph targets are stored as uint32");
+
+namespace impl {
+   const char geometry_magic[8] = { 'G', 'E', 'O', 'M', 'L', 'I', 'B', 0 };
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+   const bool is_little_endian = false;
+#else
+   const bool is_little_endian = true;
+#endif
+
+   void checkHost()
+   {
+      if (!is_little_endian)
+         throw std::runtime_error(
+           "GeometryFile: big-endian hosts are not supported");
+   }
+
+   size_t alignedSize(size_t bytes) { return (bytes + 7) / 8 * 8; }
+
+   /**
+    * @brief Output file which throws on errors; arrays are padded to a
+    * multiple of 8 bytes
+    */
+   class FileWriter
+   {
+     private:
+      std::string _path;
+      std::ofstream _out;
+
+     public:
+      explicit FileWriter(const std::string& path) : _path(path)
+      {
+         checkHost();
+         _out.open(path, std::ios::binary | std::ios::trunc);
+         if (!_out)
+            fail();
+      }
+      [[noreturn]] void fail() const
+      {
+         throw std::runtime_error("GeometryFile: cannot write '" +
+                                  _path + "'");
+      }
+      void header(GeometryFile::Kind kind, uint64_t count,
+                  uint64_t arcs = 0)
+      {
+         GeometryFile::Header header;
+         std::memcpy(header.magic, geometry_magic, sizeof(header.magic));
+         header.version = GeometryFile::version;
+         header.kind = kind;
+         header.count = count;
+         header.arcs = arcs;
+         array(&header, 1);
+      }
+      template<class T>
+      void array(const T* data, size_t count)
+      {
+         const size_t bytes = count * sizeof(T);
+         _out.write(reinterpret_cast<const char*>(data), bytes);
+         static const char padding[8] = {};
+         _out.write(padding, alignedSize(bytes) - bytes);
+         if (!_out)
+            fail();
+      }
+      /**
+       * @brief Writes `count` values converted to Stored type, in
+       * chunks so that no copy of the whole array is made
+       */
+      template<class Stored, class T>
+      void converted(const T* data, size_t count)
+      {
+         std::vector<Stored> chunk;
+         const size_t chunk_size = 65536;
+         for (size_t begin = 0; begin < count; begin += chunk_size) {
+            const size_t end = std::min(count, begin + chunk_size);
+            chunk.assign(data + begin, data + end);
+            array(chunk.data(), chunk.size());
+         }
+      }
+      void close()
+      {
+         _out.close();
+         if (!_out)
+            fail();
+      }
+   };
+
+   std::vector<Vector2> toVectors(const std::vector<Point>& points)
+   {
+      std::vector<Vector2> result(points.size());
+      for (size_t i = 0; i < points.size(); ++i)
+         result[i] = Vector2::from(points[i]);
+      return result;
+   }
+}
+
+void GeometryFile::write(const std::string& path,
+                         ArrayView<Vector2> points, Kind kind)
+{
+   GEOMETRY_TIMER("GeometryFile::write");
+   if (kind != POINTS && kind != POLYGON)
+      throw std::invalid_argument(
+        "GeometryFile: points are written as POINTS or POLYGON");
+   impl::FileWriter writer(path);
+   writer.header(kind, points.size());
+   writer.array(points.data(), points.size());
+   writer.close();
+}
+
+void GeometryFile::write(const std::string& path, const Polygon& polygon)
+{
+   const std::vector<Vector2> points = impl::toVectors(polygon.get());
+   write(path, { points.data(), points.size() }, POLYGON);
+}
+
+void GeometryFile::write(const std::string& path,
+                         ArrayView<CompactSegment> segments)
+{
+   GEOMETRY_TIMER("GeometryFile::write");
+   impl::FileWriter writer(path);
+   writer.header(SEGMENTS, segments.size());
+   writer.array(segments.data(), segments.size());
+   writer.close();
+}
+
+void GeometryFile::write(const std::string& path, const Graph& graph)
+{
+   GEOMETRY_TIMER("GeometryFile::write");
+   std::vector<Vector2> points(graph.size());
+   for (uint v = 0; v < graph.size(); ++v)
+      points[v] = Vector2::from(graph.point(v));
+   impl::FileWriter writer(path);
+   writer.header(GRAPH, graph.size(), graph._targets.size());
+   writer.array(points.data(), points.size());
+   if (graph._offsets.empty()) {
+      const uint64_t zero = 0;
+      writer.array(&zero, 1);
+   } else
+      writer.converted<uint64_t>(graph._offsets.data(),
+                                 graph._offsets.size());
+   writer.array(graph._targets.data(), graph._targets.size());
+   writer.close();
+}
+
+GeometryFile::GeometryFile(const std::string& path) : _file(path)
+{
+   impl::checkHost();
+   auto fail = [&](const std::string& reason) {
+      throw std::runtime_error("GeometryFile: '" + path + "' " + reason);
+   };
+   if (_file.size() < sizeof(Header))
+      fail("is too short");
+   std::memcpy(&_header, _file.data(), sizeof(Header));
+   if (std::memcmp(_header.magic, impl::geometry_magic,
+                   sizeof(_header.magic)) != 0)
+      fail("is not a geometry file");
+   if (_header.version == 0 || _header.version > version)
+      fail("has unsupported version " + std::to_string(_header.version));
+
+   const uint64_t available = _file.size() - sizeof(Header);
+   uint64_t expected = 0;
+   bool is_valid = true;
+   auto add = [&](uint64_t count, size_t element) {
+      // Compared by division first, so huge counts in a corrupted
+      // header cannot overflow
+      if (!is_valid || count > (available - expected) / element) {
+         is_valid = false;
+         return;
+      }
+      expected += impl::alignedSize(count * element);
+      is_valid = (expected <= available);
+   };
+   switch (_header.kind) {
+      case POINTS:
+      case POLYGON:
+         add(_header.count, sizeof(Vector2));
+         break;
+      case SEGMENTS:
+         add(_header.count, sizeof(CompactSegment));
+         break;
+      case GRAPH:
+         add(_header.count, sizeof(Vector2));
+         add(_header.count, sizeof(uint64_t));
+         add(1, sizeof(uint64_t));
+         add(_header.arcs, sizeof(uint32_t));
+         break;
+      default:
+         fail("has unknown kind " + std::to_string(_header.kind));
+   }
+   if (_header.kind != GRAPH && _header.arcs != 0)
+      is_valid = false;
+   if (!is_valid || expected != available)
+      fail("has incorrect size");
+}
+
+void GeometryFile::expectKind(Kind expected) const
+{
+   if (kind() != expected)
+      throw std::runtime_error(
+        "GeometryFile: file of kind " + std::to_string(kind()) +
+        " is not of kind " + std::to_string(expected));
+}
+
+ArrayView<Vector2> GeometryFile::points() const
+{
+   if (kind() == SEGMENTS)
+      throw std::runtime_error("GeometryFile: file of segments has no "
+                               "points");
+   return view<Vector2>(sizeof(Header), _header.count);
+}
+
+ArrayView<CompactSegment> GeometryFile::segments() const
+{
+   expectKind(SEGMENTS);
+   return view<CompactSegment>(sizeof(Header), _header.count);
+}
+
+ArrayView<uint64_t> GeometryFile::offsets() const
+{
+   expectKind(GRAPH);
+   return view<uint64_t>(sizeof(Header) + _header.count * sizeof(Vector2),
+                         _header.count + 1);
+}
+
+ArrayView<uint32_t> GeometryFile::targets() const
+{
+   expectKind(GRAPH);
+   return view<uint32_t>(sizeof(Header) +
+                           _header.count * sizeof(Vector2) +
+                           (_header.count + 1) * sizeof(uint64_t),
+                         _header.arcs);
+}
+
+Polygon GeometryFile::polygon() const
+{
+   const ArrayView<Vector2> source = points();
+   std::vector<Point> result(source.size());
+   for (size_t i = 0; i < source.size(); ++i)
+      result[i] = source[i].toPoint();
+   return Polygon(result);
+}
+
+Graph GeometryFile::graph() const
+{
+   GEOMETRY_TIMER("GeometryFile::graph");
+   const ArrayView<Vector2> source = points();
+   const ArrayView<uint64_t> offsets = this->offsets();
+   const ArrayView<uint32_t> targets = this->targets();
+   const size_t n = source.size();
+
+   // Range checks, so a corrupted file cannot cause out of bounds
+   // access later
+   bool is_valid = (offsets[0] == 0 && offsets[n] == targets.size());
+   for (size_t v = 0; v < n && is_valid; ++v)
+      is_valid = (offsets[v] <= offsets[v + 1]);
+   if (n > std::numeric_limits<uint>::max())
+      is_valid = false;
+   for (size_t i = 0; i < targets.size() && is_valid; ++i)
+      is_valid = (targets[i] < n);
+   for (size_t v = 0; v < n && is_valid; ++v)
+      is_valid = std::isfinite(source[v].x) && std::isfinite(source[v].y);
+   // Graph invariants: rows are strictly increasing, without
+   // self-loops, and adjacency is symmetric. Vertices are visited in
+   // increasing order, so arcs u -> v are met in the order of row u:
+   // each row is matched by a cursor.
+   std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+   for (size_t v = 0; v < n && is_valid; ++v)
+      for (size_t i = offsets[v]; i < offsets[v + 1] && is_valid; ++i) {
+         const uint u = targets[i];
+         is_valid = u != v &&
+                    (i == offsets[v] || targets[i - 1] < u) &&
+                    cursor[u] < offsets[u + 1] &&
+                    targets[cursor[u]] == v;
+         ++cursor[u];
+      }
+   for (size_t v = 0; v < n && is_valid; ++v)
+      is_valid = (cursor[v] == offsets[v + 1]);
+   if (!is_valid)
+      throw std::runtime_error("GeometryFile: graph arrays are corrupted");
+
+   return Graph(source.data(), n,
+                std::vector<size_t>(offsets.begin(), offsets.end()),
+                std::vector<uint>(targets.begin(), targets.end()));
+}
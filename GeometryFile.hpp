@@ -0,0 +1,118 @@
+#ifndef GEOMETRY_LIB_GEOMETRYFILE_HPP
+#define GEOMETRY_LIB_GEOMETRYFILE_HPP
+
+#include <cstdint>
+#include <string>
+
+#include "CompactSegment.hpp"
+#include "Graph.hpp"
+#include "MappedFile.hpp"
+#include "Polygon.hpp"
+#include "Vector2.hpp"
+
+/**
+ * @brief Versioned little-endian binary files of point sets, polygons,
+ * segment arrays and CSR graphs, read through MappedFile.
+ *
+ * Layout: 32-byte Header, then arrays one after another, each starts
+ * at a multiple of 8 bytes:
+ * - POINTS, POLYGON: `count` points as x, y doubles;
+ * - SEGMENTS: `count` segments as CompactSegment (begin, delta and
+ *   bounding box, 8 doubles);
+ * - GRAPH: `count` vertices as x, y doubles, `count` + 1 row offsets
+ *   as uint64 and `arcs` neighbour numbers as uint32 (see Graph).
+ *
+ * Arrays are used in place: points(), segments(), offsets() and
+ * targets() are views into the mapping, valid while `this` object
+ * lives. Only little-endian hosts are supported.
+ */
+class GeometryFile
+{
+  public:
+   enum Kind : uint32_t
+   {
+      POINTS = 1,
+      POLYGON = 2,
+      SEGMENTS = 3,
+      GRAPH = 4
+   };
+   /**
+    * @brief Version written by this library, readers accept files of
+    * this and older versions
+    */
+   static const uint32_t version = 1;
+
+   struct Header
+   {
+      char magic[8];
+      uint32_t version;
+      uint32_t kind;
+      /**
+       * @brief Points, segments or vertices count
+       */
+      uint64_t count;
+      /**
+       * @brief Arcs count of GRAPH (twice the edges count), otherwise 0
+       */
+      uint64_t arcs;
+   };
+
+   /**
+    * @brief Writers throw std::runtime_error if the file cannot be
+    * written
+    */
+   static void write(const std::string& path, ArrayView<Vector2> points,
+                     Kind kind = POINTS);
+   static void write(const std::string& path, const Polygon& polygon);
+   static void write(const std::string& path,
+                     ArrayView<CompactSegment> segments);
+   static void write(const std::string& path, const Graph& graph);
+
+   /**
+    * @brief Maps the file and checks its header and size, throws
+    * std::runtime_error if the file is not a valid geometry file
+    */
+   explicit GeometryFile(const std::string& path);
+
+   Kind kind() const { return static_cast<Kind>(_header.kind); }
+   const Header& header() const { return _header; }
+
+   /**
+    * @brief Points of POINTS, POLYGON or GRAPH file
+    */
+   ArrayView<Vector2> points() const;
+   ArrayView<CompactSegment> segments() const;
+   /**
+    * @brief Row offsets of GRAPH file
+    */
+   ArrayView<uint64_t> offsets() const;
+   /**
+    * @brief Concatenated neighbour lists of GRAPH file
+    */
+   ArrayView<uint32_t> targets() const;
+
+   /**
+    * @brief Copy of POINTS or POLYGON file as a Polygon
+    */
+   Polygon polygon() const;
+   /**
+    * @brief Copy of GRAPH file. CSR arrays are copied as is after
+    * O(V + E) checks of ranges and Graph invariants (finite points,
+    * sorted unique rows, no self-loops, symmetric adjacency), adjacency
+    * is not rebuilt. Throws std::runtime_error if a check fails.
+    */
+   Graph graph() const;
+
+  private:
+   MappedFile _file;
+   Header _header;
+
+   void expectKind(Kind expected) const;
+   template<class T>
+   ArrayView<T> view(size_t offset, size_t count) const
+   {
+      return { reinterpret_cast<const T*>(_file.data() + offset), count };
+   }
+};
+
+#endif // GEOMETRY_LIB_GEOMETRYFILE_HPP
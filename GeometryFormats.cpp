@@ -0,0 +1,892 @@
+#include "GeometryFormats.hpp"
+#include "Instrumentation.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace impl {
+   /**
+    * @brief Longest number token, a number is parsed from a contiguous
+    * part of the buffer
+    */
+   const size_t max_number_length = 128;
+   /**
+    * @brief Nesting limit of GeoJSON values, so the recursive parser
+    * cannot overflow the stack
+    */
+   const size_t max_json_depth = 256;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+   const bool is_host_little_endian = false;
+#else
+   const bool is_host_little_endian = true;
+#endif
+
+   const char* const wkt_names[] = { "",
+                                     "POINT",
+                                     "LINESTRING",
+                                     "POLYGON",
+                                     "MULTIPOINT",
+                                     "MULTILINESTRING",
+                                     "MULTIPOLYGON" };
+   const char* const geojson_names[] = { "",
+                                         "Point",
+                                         "LineString",
+                                         "Polygon",
+                                         "MultiPoint",
+                                         "MultiLineString",
+                                         "MultiPolygon" };
+
+   ChunkedInput::ChunkedInput(std::istream& input, size_t chunk) :
+     _input(input),
+     _chunk(std::max<size_t>(chunk, max_number_length))
+   {
+   }
+
+   bool ChunkedInput::fill(size_t count)
+   {
+      if (available() >= count)
+         return true;
+      // Keep unread bytes, read the next chunk after them
+      if (_begin > 0) {
+         std::memmove(_buffer.data(), _buffer.data() + _begin,
+                      available());
+         _position += _begin;
+         _end -= _begin;
+         _begin = 0;
+      }
+      if (_buffer.size() < std::max(count, _chunk))
+         _buffer.resize(std::max(count, _chunk));
+      while (_end < count && _input) {
+         _input.read(_buffer.data() + _end, _buffer.size() - _end);
+         _end += _input.gcount();
+      }
+      return _end >= count;
+   }
+
+   void ChunkedInput::fail(const char* format,
+                           const std::string& message) const
+   {
+      throw std::runtime_error(std::string(format) + ": " + message +
+                               " at offset " + std::to_string(offset()));
+   }
+
+   double parseNumber(ChunkedInput& input, const char* format)
+   {
+      input.fill(max_number_length);
+      const char* first = input.data();
+      const char* last = first + input.available();
+      if (first != last && *first == '+')
+         ++first;
+      double result;
+      const auto [end, error] = std::from_chars(first, last, result);
+      if (error != std::errc())
+         input.fail(format, "expected a number");
+      input.skip(end - input.data());
+      return result;
+   }
+
+   bool isNumberStart(int c)
+   {
+      return std::isdigit(c) || c == '-' || c == '+' || c == '.';
+   }
+
+   /**
+    * @brief Output buffer flushed to the stream in large blocks
+    */
+   class BufferedOutput
+   {
+     private:
+      std::ostream& _output;
+      std::string _buffer;
+
+     public:
+      explicit BufferedOutput(std::ostream& output) : _output(output)
+      {
+         _buffer.reserve(1 << 16);
+      }
+      ~BufferedOutput() { flush(); }
+
+      void text(const char* value) { _buffer += value; }
+      void character(char value) { _buffer += value; }
+      void number(double value)
+      {
+         char digits[32];
+         const auto result =
+           std::to_chars(digits, digits + sizeof(digits), value);
+         _buffer.append(digits, result.ptr);
+      }
+      template<class T>
+      void littleEndian(T value)
+      {
+         unsigned char bytes[sizeof(T)];
+         std::memcpy(bytes, &value, sizeof(T));
+         if (!is_host_little_endian)
+            std::reverse(bytes, bytes + sizeof(T));
+         _buffer.append(reinterpret_cast<const char*>(bytes), sizeof(T));
+      }
+      void flushIfFull()
+      {
+         if (_buffer.size() >= (1 << 16))
+            flush();
+      }
+      void flush()
+      {
+         _output.write(_buffer.data(), _buffer.size());
+         _buffer.clear();
+      }
+   };
+
+   size_t clampEnd(const GeometryBatch& batch, size_t end)
+   {
+      return std::min(end, batch.size());
+   }
+}
+
+using Type = GeometryBatch::Type;
+
+GeometryFormats::WktReader::WktReader(std::istream& input, size_t chunk) :
+  _input(input, chunk)
+{
+}
+
+void GeometryFormats::WktReader::skipSpaces()
+{
+   while (std::isspace(_input.peek()))
+      _input.skip(1);
+}
+
+std::string GeometryFormats::WktReader::word()
+{
+   skipSpaces();
+   std::string result;
+   for (int c = _input.peek(); std::isalpha(c); c = _input.peek()) {
+      result += std::toupper(c);
+      _input.skip(1);
+   }
+   return result;
+}
+
+void GeometryFormats::WktReader::expect(char c)
+{
+   if (!skipIf(c))
+      _input.fail("WKT", std::string("expected '") + c + "'");
+}
+
+bool GeometryFormats::WktReader::skipIf(char c)
+{
+   skipSpaces();
+   if (_input.peek() != c)
+      return false;
+   _input.skip(1);
+   return true;
+}
+
+bool GeometryFormats::WktReader::open()
+{
+   if (skipIf('('))
+      return true;
+   const std::string empty = word();
+   if (empty == "EMPTY")
+      return false;
+   if (empty == "Z" || empty == "M" || empty == "ZM")
+      _input.fail("WKT", "Z and M coordinates are not supported");
+   _input.fail("WKT", "expected '(' or EMPTY");
+}
+
+void GeometryFormats::WktReader::coordinate(GeometryBatch& batch)
+{
+   skipSpaces();
+   const double x = impl::parseNumber(_input, "WKT");
+   skipSpaces();
+   const double y = impl::parseNumber(_input, "WKT");
+   skipSpaces();
+   if (impl::isNumberStart(_input.peek()))
+      _input.fail("WKT", "Z and M coordinates are not supported");
+   batch.addCoordinate(x, y);
+}
+
+void GeometryFormats::WktReader::ring(GeometryBatch& batch)
+{
+   do
+      coordinate(batch);
+   while (skipIf(','));
+   batch.closeRing();
+}
+
+void GeometryFormats::WktReader::part(GeometryBatch& batch, Type type)
+{
+   // '(' of the part is read
+   switch (type) {
+      case GeometryBatch::POINT:
+         coordinate(batch);
+         batch.closeRing();
+         break;
+      case GeometryBatch::LINESTRING:
+         ring(batch);
+         break;
+      default:
+         do
+            if (open()) {
+               ring(batch);
+               expect(')');
+            } else
+               batch.closeRing();
+         while (skipIf(','));
+   }
+   expect(')');
+   batch.closePart();
+}
+
+size_t GeometryFormats::WktReader::read(GeometryBatch& batch,
+                                        size_t max_count)
+{
+   GEOMETRY_TIMER("GeometryFormats::WktReader::read");
+   const size_t before = batch.size();
+   size_t count = 0;
+   try {
+      for (; count < max_count; ++count) {
+         skipSpaces();
+         if (_input.peek() < 0)
+            break;
+         const std::string name = word();
+         const auto found = std::find(std::begin(impl::wkt_names) + 1,
+                                      std::end(impl::wkt_names), name);
+         if (found == std::end(impl::wkt_names))
+            _input.fail("WKT", "unsupported geometry '" + name + "'");
+         const Type type = Type(found - std::begin(impl::wkt_names));
+         const Type part_type = GeometryBatch::partType(type);
+         if (open()) {
+            if (!GeometryBatch::isMulti(type))
+               part(batch, type);
+            else {
+               do {
+                  // MULTIPOINT allows points without parentheses
+                  skipSpaces();
+                  if (part_type == GeometryBatch::POINT &&
+                      impl::isNumberStart(_input.peek())) {
+                     coordinate(batch);
+                     batch.closeRing();
+                     batch.closePart();
+                  } else if (open())
+                     part(batch, part_type);
+                  else
+                     batch.closePart();
+               } while (skipIf(','));
+               expect(')');
+            }
+         }
+         batch.closeGeometry(type);
+      }
+   } catch (...) {
+      batch.truncate(before + count);
+      throw;
+   }
+   return count;
+}
+
+GeometryFormats::WkbReader::WkbReader(std::istream& input, size_t chunk) :
+  _input(input, chunk)
+{
+}
+
+template<class T>
+T GeometryFormats::WkbReader::value(bool is_little_endian)
+{
+   if (!_input.fill(sizeof(T)))
+      _input.fail("WKB", "unexpected end of input");
+   unsigned char bytes[sizeof(T)];
+   std::memcpy(bytes, _input.data(), sizeof(T));
+   _input.skip(sizeof(T));
+   if (is_little_endian != impl::is_host_little_endian)
+      std::reverse(bytes, bytes + sizeof(T));
+   T result;
+   std::memcpy(&result, bytes, sizeof(T));
+   return result;
+}
+
+void GeometryFormats::WkbReader::coordinates(GeometryBatch& batch,
+                                             uint32_t count,
+                                             bool is_little_endian)
+{
+   const size_t size = 2 * sizeof(double);
+   while (count > 0) {
+      if (!_input.fill(size))
+         _input.fail("WKB", "unexpected end of input");
+      // All coordinates available in the buffer at once
+      const size_t chunk =
+        std::min<size_t>(count, _input.available() / size);
+      for (size_t i = 0; i < chunk; ++i) {
+         const double x = value<double>(is_little_endian);
+         batch.addCoordinate(x, value<double>(is_little_endian));
+      }
+      count -= chunk;
+   }
+}
+
+void GeometryFormats::WkbReader::geometry(GeometryBatch& batch,
+                                          int depth, Type expected)
+{
+   const unsigned char order = value<unsigned char>(true);
+   if (order > 1)
+      _input.fail("WKB", "incorrect byte order");
+   const bool is_little_endian = (order == 1);
+   const uint32_t code = value<uint32_t>(is_little_endian);
+   if (code > 1000 || (code & 0xE0000000u))
+      _input.fail("WKB", "Z, M and SRID are not supported");
+   if (code < GeometryBatch::POINT || code > GeometryBatch::MULTIPOLYGON)
+      _input.fail("WKB",
+                  "unsupported geometry type " + std::to_string(code));
+   const Type type = Type(code);
+   if (depth > 0 && type != expected)
+      _input.fail("WKB", "unexpected part type " + std::to_string(code));
+
+   // Empty geometries have no parts, empty parts of MULTI* have no
+   // rings
+   bool is_empty = false;
+   if (GeometryBatch::isMulti(type)) {
+      const uint32_t count = value<uint32_t>(is_little_endian);
+      for (uint32_t i = 0; i < count; ++i)
+         geometry(batch, depth + 1, GeometryBatch::partType(type));
+   } else if (type == GeometryBatch::POINT) {
+      const double x = value<double>(is_little_endian),
+                   y = value<double>(is_little_endian);
+      // Empty point is (NaN, NaN)
+      is_empty = std::isnan(x) && std::isnan(y);
+      if (!is_empty) {
+         batch.addCoordinate(x, y);
+         batch.closeRing();
+      }
+   } else if (type == GeometryBatch::LINESTRING) {
+      const uint32_t count = value<uint32_t>(is_little_endian);
+      coordinates(batch, count, is_little_endian);
+      is_empty = (count == 0);
+      if (!is_empty)
+         batch.closeRing();
+   } else {
+      const uint32_t rings = value<uint32_t>(is_little_endian);
+      for (uint32_t r = 0; r < rings; ++r) {
+         coordinates(batch, value<uint32_t>(is_little_endian),
+                     is_little_endian);
+         batch.closeRing();
+      }
+      is_empty = (rings == 0);
+   }
+   if (!GeometryBatch::isMulti(type) && (!is_empty || depth > 0))
+      batch.closePart();
+   if (depth == 0)
+      batch.closeGeometry(type);
+}
+
+size_t GeometryFormats::WkbReader::read(GeometryBatch& batch,
+                                        size_t max_count)
+{
+   GEOMETRY_TIMER("GeometryFormats::WkbReader::read");
+   const size_t before = batch.size();
+   size_t count = 0;
+   try {
+      for (; count < max_count && _input.peek() >= 0; ++count)
+         geometry(batch, 0, GeometryBatch::POINT);
+   } catch (...) {
+      batch.truncate(before + count);
+      throw;
+   }
+   return count;
+}
+
+void GeometryFormats::GeoJsonReader::Coordinates::clear()
+{
+   x.clear();
+   y.clear();
+   for (auto&& level : ends)
+      level.clear();
+   depth = -1;
+}
+
+GeometryFormats::GeoJsonReader::GeoJsonReader(std::istream& input,
+                                              size_t chunk) :
+  _input(input, chunk)
+{
+}
+
+void GeometryFormats::GeoJsonReader::skipSpaces()
+{
+   while (std::isspace(_input.peek()))
+      _input.skip(1);
+}
+
+void GeometryFormats::GeoJsonReader::expect(char c)
+{
+   skipSpaces();
+   if (_input.peek() != c)
+      _input.fail("GeoJSON", std::string("expected '") + c + "'");
+   _input.skip(1);
+}
+
+std::string GeometryFormats::GeoJsonReader::string()
+{
+   expect('"');
+   std::string result;
+   while (true) {
+      if (!_input.fill(1))
+         _input.fail("GeoJSON", "unterminated string");
+      // Copy the run up to a quote or an escape at once
+      const char* begin = _input.data();
+      const char* end = begin + _input.available();
+      const char* stop = begin;
+      while (stop != end && *stop != '"' && *stop != '\\')
+         ++stop;
+      result.append(begin, stop);
+      _input.skip(stop - begin);
+      if (stop == end)
+         continue;
+      _input.skip(1);
+      if (*stop == '"')
+         return result;
+      // Escapes are kept as is, only names of types and members are
+      // compared
+      const int escaped = _input.peek();
+      if (escaped < 0)
+         _input.fail("GeoJSON", "unterminated string");
+      result += '\\';
+      result += char(escaped);
+      _input.skip(1);
+   }
+}
+
+double GeometryFormats::GeoJsonReader::number()
+{
+   skipSpaces();
+   return impl::parseNumber(_input, "GeoJSON");
+}
+
+void GeometryFormats::GeoJsonReader::value(GeometryBatch& batch,
+                                           size_t depth)
+{
+   if (depth > impl::max_json_depth)
+      _input.fail("GeoJSON", "nesting is too deep");
+   skipSpaces();
+   const int c = _input.peek();
+   if (c == '{') {
+      _input.skip(1);
+      members(batch, depth);
+   } else if (c == '[') {
+      _input.skip(1);
+      while (true) {
+         skipSpaces();
+         const int next = _input.peek();
+         if (next == ']') {
+            _input.skip(1);
+            break;
+         }
+         if (next == ',')
+            _input.skip(1);
+         else
+            value(batch, depth + 1);
+      }
+   } else if (c == '"')
+      string();
+   else if (std::isalpha(c))
+      while (std::isalpha(_input.peek()))
+         _input.skip(1);
+   else if (c >= 0)
+      number();
+   else
+      _input.fail("GeoJSON", "unexpected end of input");
+}
+
+void GeometryFormats::GeoJsonReader::members(GeometryBatch& batch,
+                                             size_t depth)
+{
+   if (_scratch.size() <= depth)
+      _scratch.resize(depth + 1);
+   Coordinates& parsed = _scratch[depth];
+   parsed.clear();
+   std::string type;
+   bool has_coordinates = false;
+   while (true) {
+      skipSpaces();
+      const int c = _input.peek();
+      if (c == '}') {
+         _input.skip(1);
+         break;
+      }
+      if (c == ',') {
+         _input.skip(1);
+         continue;
+      }
+      const std::string key = string();
+      expect(':');
+      skipSpaces();
+      if (key == "type" && _input.peek() == '"')
+         type = string();
+      else if (key == "coordinates") {
+         coordinates(parsed, 0);
+         has_coordinates = true;
+      } else if (depth == 0 && key == "features" &&
+                 _input.peek() == '[') {
+         // Features are read one by one by read()
+         _input.skip(1);
+         _in_array = true;
+         return;
+      } else
+         value(batch, depth + 1);
+   }
+   if (depth == 0)
+      _in_object = false;
+   if (has_coordinates)
+      emit(batch, type, parsed);
+}
+
+void GeometryFormats::GeoJsonReader::coordinates(Coordinates& result,
+                                                 int depth)
+{
+   if (depth > 3)
+      _input.fail("GeoJSON", "coordinates are nested too deep");
+   expect('[');
+   skipSpaces();
+   if (impl::isNumberStart(_input.peek())) {
+      // Position, the third and next numbers are ignored
+      if (result.depth >= 0 && result.depth != depth)
+         _input.fail("GeoJSON", "positions of different nesting");
+      result.depth = depth;
+      result.x.push_back(number());
+      expect(',');
+      result.y.push_back(number());
+      skipSpaces();
+      while (_input.peek() == ',') {
+         _input.skip(1);
+         number();
+         skipSpaces();
+      }
+      expect(']');
+      return;
+   }
+   while (true) {
+      skipSpaces();
+      const int c = _input.peek();
+      if (c == ']') {
+         _input.skip(1);
+         break;
+      }
+      if (c == ',')
+         _input.skip(1);
+      else
+         coordinates(result, depth + 1);
+   }
+   // End of this array in terms of its elements
+   result.ends[depth].push_back(result.depth == depth + 1
+                                  ? result.x.size()
+                                  : result.ends[depth + 1].size());
+}
+
+void GeometryFormats::GeoJsonReader::emit(GeometryBatch& batch,
+                                          const std::string& name,
+                                          const Coordinates& parsed)
+{
+   const auto found = std::find(std::begin(impl::geojson_names) + 1,
+                                std::end(impl::geojson_names), name);
+   if (found == std::end(impl::geojson_names))
+      return;
+   const Type type = Type(found - std::begin(impl::geojson_names));
+   if (parsed.depth < 0) {
+      batch.closeGeometry(type);
+      return;
+   }
+   // Nesting of positions by type
+   static const int nesting[] = { 0, 0, 1, 2, 1, 2, 3 };
+   if (parsed.depth != nesting[type])
+      _input.fail("GeoJSON", "coordinates do not match type " + name);
+
+   size_t position = 0;
+   auto ring = [&](size_t end) {
+      for (; position < end; ++position)
+         batch.addCoordinate(parsed.x[position], parsed.y[position]);
+      batch.closeRing();
+   };
+   switch (type) {
+      case GeometryBatch::POINT:
+      case GeometryBatch::LINESTRING:
+         ring(parsed.x.size());
+         batch.closePart();
+         break;
+      case GeometryBatch::MULTIPOINT:
+         while (position < parsed.x.size()) {
+            ring(position + 1);
+            batch.closePart();
+         }
+         break;
+      case GeometryBatch::POLYGON:
+         for (size_t end : parsed.ends[1])
+            ring(end);
+         batch.closePart();
+         break;
+      case GeometryBatch::MULTILINESTRING:
+         for (size_t end : parsed.ends[1]) {
+            ring(end);
+            batch.closePart();
+         }
+         break;
+      case GeometryBatch::MULTIPOLYGON: {
+         size_t ring_index = 0;
+         for (size_t rings_end : parsed.ends[1]) {
+            for (; ring_index < rings_end; ++ring_index)
+               ring(parsed.ends[2][ring_index]);
+            batch.closePart();
+         }
+         break;
+      }
+   }
+   batch.closeGeometry(type);
+}
+
+size_t GeometryFormats::GeoJsonReader::read(GeometryBatch& batch,
+                                            size_t max_count)
+{
+   GEOMETRY_TIMER("GeometryFormats::GeoJsonReader::read");
+   const size_t before = batch.size();
+   try {
+      while (batch.size() - before < max_count) {
+         skipSpaces();
+         const int c = _input.peek();
+         if (_in_array) {
+            if (c == ',')
+               _input.skip(1);
+            else if (c == ']') {
+               _input.skip(1);
+               _in_array = false;
+               // The rest of the object with "features"
+               if (_in_object)
+                  members(batch, 0);
+            } else
+               value(batch, 1);
+         } else if (c < 0)
+            break;
+         else if (c == '[') {
+            _input.skip(1);
+            _in_array = true;
+         } else if (c == '{') {
+            _input.skip(1);
+            _in_object = true;
+            members(batch, 0);
+         } else
+            value(batch, 0);
+      }
+   } catch (...) {
+      // Geometries completed before the error are kept, as by WKT and
+      // WKB readers; a partly added one is dropped
+      batch.truncate(batch.size());
+      throw;
+   }
+   return batch.size() - before;
+}
+
+namespace impl {
+   void wktPart(BufferedOutput& out, const GeometryBatch& batch,
+                size_t part, Type type)
+   {
+      const size_t first = batch.parts[part], last = batch.parts[part + 1];
+      if (first == last) {
+         out.text("EMPTY");
+         return;
+      }
+      if (type == GeometryBatch::POLYGON)
+         out.character('(');
+      for (size_t r = first; r < last; ++r) {
+         if (r != first)
+            out.text(", ");
+         if (batch.rings[r] == batch.rings[r + 1]) {
+            out.text("EMPTY");
+            continue;
+         }
+         out.character('(');
+         for (size_t i = batch.rings[r]; i < batch.rings[r + 1]; ++i) {
+            if (i != batch.rings[r])
+               out.text(", ");
+            out.number(batch.x[i]);
+            out.character(' ');
+            out.number(batch.y[i]);
+         }
+         out.character(')');
+      }
+      if (type == GeometryBatch::POLYGON)
+         out.character(')');
+   }
+
+   /**
+    * @brief Empty point is (NaN, NaN), other empty parts have no rings
+    * or points
+    */
+   void wkbEmpty(BufferedOutput& out, Type type)
+   {
+      out.character(1);
+      out.littleEndian<uint32_t>(type);
+      if (type == GeometryBatch::POINT) {
+         out.littleEndian(std::nan(""));
+         out.littleEndian(std::nan(""));
+      } else
+         out.littleEndian<uint32_t>(0);
+   }
+
+   void wkbPart(BufferedOutput& out, const GeometryBatch& batch,
+                size_t part, Type type)
+   {
+      const size_t first = batch.parts[part], last = batch.parts[part + 1];
+      if (first == last) {
+         wkbEmpty(out, type);
+         return;
+      }
+      out.character(1);
+      out.littleEndian<uint32_t>(type);
+      if (type == GeometryBatch::POINT) {
+         out.littleEndian(batch.x[batch.rings[first]]);
+         out.littleEndian(batch.y[batch.rings[first]]);
+         return;
+      }
+      if (type == GeometryBatch::POLYGON)
+         out.littleEndian<uint32_t>(last - first);
+      for (size_t r = first; r < last; ++r) {
+         out.littleEndian<uint32_t>(batch.rings[r + 1] - batch.rings[r]);
+         for (size_t i = batch.rings[r]; i < batch.rings[r + 1]; ++i) {
+            out.littleEndian(batch.x[i]);
+            out.littleEndian(batch.y[i]);
+         }
+      }
+   }
+
+   void geoJsonPart(BufferedOutput& out, const GeometryBatch& batch,
+                    size_t part, Type type)
+   {
+      const size_t first = batch.parts[part], last = batch.parts[part + 1];
+      auto ring = [&](size_t r) {
+         for (size_t i = batch.rings[r]; i < batch.rings[r + 1]; ++i) {
+            if (i != batch.rings[r])
+               out.character(',');
+            out.character('[');
+            out.number(batch.x[i]);
+            out.character(',');
+            out.number(batch.y[i]);
+            out.character(']');
+         }
+      };
+      if (type == GeometryBatch::POINT) {
+         // Empty point is an empty array
+         out.character('[');
+         if (first != last) {
+            out.number(batch.x[batch.rings[first]]);
+            out.character(',');
+            out.number(batch.y[batch.rings[first]]);
+         }
+         out.character(']');
+         return;
+      }
+      out.character('[');
+      for (size_t r = first; r < last; ++r) {
+         if (type == GeometryBatch::POLYGON) {
+            if (r != first)
+               out.character(',');
+            out.character('[');
+         }
+         ring(r);
+         if (type == GeometryBatch::POLYGON)
+            out.character(']');
+      }
+      out.character(']');
+   }
+}
+
+void GeometryFormats::writeWkt(std::ostream& output,
+                               const GeometryBatch& batch, size_t begin,
+                               size_t end)
+{
+   impl::BufferedOutput out(output);
+   end = impl::clampEnd(batch, end);
+   for (size_t g = begin; g < end; ++g) {
+      const Type type = batch.types[g];
+      const size_t first = batch.geometries[g],
+                   last = batch.geometries[g + 1];
+      out.text(impl::wkt_names[type]);
+      out.character(' ');
+      if (first == last)
+         out.text("EMPTY");
+      else if (!GeometryBatch::isMulti(type))
+         impl::wktPart(out, batch, first, type);
+      else {
+         out.character('(');
+         for (size_t p = first; p < last; ++p) {
+            if (p != first)
+               out.text(", ");
+            impl::wktPart(out, batch, p, GeometryBatch::partType(type));
+         }
+         out.character(')');
+      }
+      out.character('\n');
+      out.flushIfFull();
+   }
+}
+
+void GeometryFormats::writeWkb(std::ostream& output,
+                               const GeometryBatch& batch, size_t begin,
+                               size_t end)
+{
+   impl::BufferedOutput out(output);
+   end = impl::clampEnd(batch, end);
+   for (size_t g = begin; g < end; ++g) {
+      const Type type = batch.types[g];
+      const size_t first = batch.geometries[g],
+                   last = batch.geometries[g + 1];
+      if (GeometryBatch::isMulti(type)) {
+         out.character(1);
+         out.littleEndian<uint32_t>(type);
+         out.littleEndian<uint32_t>(last - first);
+         for (size_t p = first; p < last; ++p)
+            impl::wkbPart(out, batch, p, GeometryBatch::partType(type));
+      } else if (first == last)
+         impl::wkbEmpty(out, type);
+      else
+         impl::wkbPart(out, batch, first, type);
+      out.flushIfFull();
+   }
+}
+
+void GeometryFormats::writeGeoJson(std::ostream& output,
+                                   const GeometryBatch& batch,
+                                   size_t begin, size_t end)
+{
+   impl::BufferedOutput out(output);
+   end = impl::clampEnd(batch, end);
+   for (size_t g = begin; g < end; ++g) {
+      const Type type = batch.types[g];
+      const size_t first = batch.geometries[g],
+                   last = batch.geometries[g + 1];
+      out.text("{\"type\":\"");
+      out.text(impl::geojson_names[type]);
+      out.text("\",\"coordinates\":");
+      if (first == last)
+         out.text("[]");
+      else if (!GeometryBatch::isMulti(type))
+         impl::geoJsonPart(out, batch, first, type);
+      else {
+         const Type part_type = GeometryBatch::partType(type);
+         out.character('[');
+         bool is_first = true;
+         for (size_t p = first; p < last; ++p) {
+            // Empty position is not valid GeoJSON
+            if (part_type == GeometryBatch::POINT &&
+                batch.parts[p] == batch.parts[p + 1])
+               continue;
+            if (!is_first)
+               out.character(',');
+            is_first = false;
+            impl::geoJsonPart(out, batch, p, part_type);
+         }
+         out.character(']');
+      }
+      out.text("}\n");
+      out.flushIfFull();
+   }
+}
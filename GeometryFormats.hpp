@@ -0,0 +1,215 @@
+#ifndef GEOMETRY_LIB_GEOMETRYFORMATS_HPP
+#define GEOMETRY_LIB_GEOMETRYFORMATS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "GeometryBatch.hpp"
+
+namespace impl {
+   /**
+    * @brief Input stream read in chunks into a reused buffer. Parsers
+    * request how many bytes they need contiguous, so memory is bounded
+    * by the chunk size and the largest token.
+    */
+   class ChunkedInput
+   {
+     private:
+      std::istream& _input;
+      std::vector<char> _buffer;
+      size_t _begin = 0, _end = 0;
+      /**
+       * @brief Offset of _buffer[0] in the stream, for error messages
+       */
+      size_t _position = 0;
+      const size_t _chunk;
+
+     public:
+      ChunkedInput(std::istream& input, size_t chunk);
+
+      /**
+       * @brief Makes at least `count` bytes available (fewer at the end
+       * of the stream)
+       * @return true if `count` bytes are available
+       */
+      bool fill(size_t count);
+      const char* data() const { return _buffer.data() + _begin; }
+      size_t available() const { return _end - _begin; }
+      void skip(size_t count) { _begin += count; }
+      /**
+       * @brief The next byte, or -1 at the end of the stream
+       */
+      int peek()
+      {
+         if (_begin == _end && !fill(1))
+            return -1;
+         return static_cast<unsigned char>(_buffer[_begin]);
+      }
+      size_t offset() const { return _position + _begin; }
+      [[noreturn]] void fail(const char* format,
+                             const std::string& message) const;
+   };
+}
+
+/**
+ * @brief Streaming readers and writers of well-known text (WKT),
+ * well-known binary (WKB) and a GeoJSON subset: POINT, LINESTRING,
+ * POLYGON and their MULTI* collections with two coordinates. Other
+ * geometries, Z and M coordinates throw std::runtime_error with the
+ * offset of the error.
+ *
+ * Readers parse the input in chunks and append geometries straight to
+ * a GeometryBatch, so a stream of any size is processed with bounded
+ * memory by reading it batch by batch. Numbers are parsed and printed
+ * by std::from_chars and std::to_chars (shortest exact form).
+ */
+class GeometryFormats
+{
+  public:
+   static const size_t default_chunk = 1 << 16;
+   static const size_t all = std::numeric_limits<size_t>::max();
+
+   /**
+    * @brief WKT geometries separated by whitespace, for example one per
+    * line
+    */
+   class WktReader
+   {
+     private:
+      impl::ChunkedInput _input;
+
+      void skipSpaces();
+      std::string word();
+      void expect(char c);
+      bool skipIf(char c);
+      /**
+       * @brief Reads `EMPTY` or '('
+       * @return false for EMPTY
+       */
+      bool open();
+      void coordinate(GeometryBatch& batch);
+      void ring(GeometryBatch& batch);
+      void part(GeometryBatch& batch, GeometryBatch::Type type);
+
+     public:
+      explicit WktReader(std::istream& input,
+                         size_t chunk = default_chunk);
+      /**
+       * @brief Appends up to `max_count` next geometries to `batch`.
+       * If an error is thrown, the batch keeps geometries read before.
+       *
+       * @return count of geometries read, 0 at the end of input
+       */
+      size_t read(GeometryBatch& batch, size_t max_count = all);
+   };
+
+   /**
+    * @brief Concatenated WKB geometries of any byte order
+    */
+   class WkbReader
+   {
+     private:
+      impl::ChunkedInput _input;
+
+      template<class T>
+      T value(bool is_little_endian);
+      void geometry(GeometryBatch& batch, int depth,
+                    GeometryBatch::Type expected);
+      void coordinates(GeometryBatch& batch, uint32_t count,
+                       bool is_little_endian);
+
+     public:
+      explicit WkbReader(std::istream& input,
+                         size_t chunk = default_chunk);
+      /**
+       * @brief See WktReader::read
+       */
+      size_t read(GeometryBatch& batch, size_t max_count = all);
+   };
+
+   /**
+    * @brief Geometry objects with "type" and "coordinates" members,
+    * nested anywhere in a stream of JSON values (for example features
+    * of a FeatureCollection or newline-delimited geometries). Elements
+    * of a top-level array and of "features" arrays are read one by
+    * one; other members are skipped. Empty positions (of MultiPoint)
+    * are not valid GeoJSON and are dropped.
+    */
+   class GeoJsonReader
+   {
+     private:
+      impl::ChunkedInput _input;
+      /**
+       * @brief Inside a top-level array or "features" array of a
+       * top-level object
+       */
+      bool _in_array = false;
+      bool _in_object = false;
+      /**
+       * @brief Parsed "coordinates": positions and ends of arrays by
+       * nesting depth
+       */
+      struct Coordinates
+      {
+         std::vector<double> x, y;
+         std::vector<size_t> ends[4];
+         int depth = -1;
+         void clear();
+      };
+      /**
+       * @brief Coordinates of objects by nesting depth, reused
+       */
+      std::deque<Coordinates> _scratch;
+
+      void skipSpaces();
+      void expect(char c);
+      std::string string();
+      double number();
+      void value(GeometryBatch& batch, size_t depth);
+      /**
+       * @brief Parses members up to '}', or up to "features" array of
+       * the top-level object
+       */
+      void members(GeometryBatch& batch, size_t depth);
+      void coordinates(Coordinates& result, int depth);
+      void emit(GeometryBatch& batch, const std::string& type,
+                const Coordinates& coordinates);
+
+     public:
+      explicit GeoJsonReader(std::istream& input,
+                             size_t chunk = default_chunk);
+      /**
+       * @brief See WktReader::read. Array elements are read whole, so
+       * an element with several geometries (GeometryCollection) may
+       * exceed `max_count`.
+       */
+      size_t read(GeometryBatch& batch, size_t max_count = all);
+   };
+
+   /**
+    * @brief Writes geometries [begin, end) of `batch`, one per line
+    */
+   static void writeWkt(std::ostream& output, const GeometryBatch& batch,
+                        size_t begin = 0, size_t end = all);
+   /**
+    * @brief Writes geometries [begin, end) of `batch` as concatenated
+    * little-endian WKB
+    */
+   static void writeWkb(std::ostream& output, const GeometryBatch& batch,
+                        size_t begin = 0, size_t end = all);
+   /**
+    * @brief Writes geometries [begin, end) of `batch` as GeoJSON
+    * geometry objects, one per line. EMPTY points of MULTIPOINT are
+    * skipped, as GeoJSON has no empty positions.
+    */
+   static void writeGeoJson(std::ostream& output,
+                            const GeometryBatch& batch, size_t begin = 0,
+                            size_t end = all);
+};
+
+#endif // GEOMETRY_LIB_GEOMETRYFORMATS_HPP
@@ -1,4 +1,21 @@
 #include "Graph.hpp"
+#include "Instrumentation.hpp"
+#include "MappedFile.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 struct Graph::NumberedPoint
 {
@@ -11,19 +28,921 @@ struct Graph::NumberedPoint
       _p = Point();
    }
 
-   NumberedPoint(Point p, unsigned int numder)
+   NumberedPoint(const Point& p, unsigned int numder) :
+     _numder(numder), _p(p)
+   {
+   }
+
+   NumberedPoint(double x, double y, unsigned int numder) :
+     _numder(numder), _p(x, y)
    {
-      _numder = numder;
-      _p = Point(p);
    }
 };
 
+Graph::Graph() {}
+
 Graph::Graph(const matrix_t& adjacencyMatrix, std::vector<Point> points)
 {
-    _adjacencyMatrix = matrix_t(adjacencyMatrix);
-    _points = std::vector<NumberedPoint>(points.size());
-    for (int i = 0; i < _points.size(); i++)
-        _points[i] = NumberedPoint(points[i], i);
+   if (adjacencyMatrix.size() != points.size())
+      throw std::invalid_argument(
+        "Graph: adjacency matrix size differs from points count");
+
+   _points.reserve(points.size());
+   for (uint i = 0; i < points.size(); i++)
+      _points.emplace_back(points[i], i);
+
+   edge_list_t edges;
+   for (uint i = 0; i < adjacencyMatrix.size(); i++)
+      for (uint j = 0; j < adjacencyMatrix[i].size(); j++)
+         if (adjacencyMatrix[i][j] != 0)
+            edges.push_back({ i, j });
+   buildAdjacency(edges);
+}
+
+Graph::Graph(const edge_list_t& edges, std::vector<Point> points)
+{
+   _points.reserve(points.size());
+   for (uint i = 0; i < points.size(); i++)
+      _points.emplace_back(points[i], i);
+   buildAdjacency(edges);
+}
+
+Graph::Graph(const Vector2* points, size_t count,
+             std::vector<size_t> offsets, std::vector<uint> targets) :
+  _offsets(std::move(offsets)),
+  _targets(std::move(targets))
+{
+   _points.reserve(count);
+   for (uint i = 0; i < count; i++)
+      _points.emplace_back(points[i].x, points[i].y, i);
+   // Same operations as Point::distance, without its bounds checks
+   _lengths.resize(_targets.size());
+   impl::parallelFor(0, count, 4096, [&](size_t begin, size_t end) {
+      for (size_t v = begin; v < end; ++v)
+         for (size_t i = _offsets[v]; i < _offsets[v + 1]; ++i) {
+            const Vector2 d = points[_targets[i]] - points[v];
+            _lengths[i] = std::sqrt(d.y * d.y + d.x * d.x);
+         }
+   });
+}
+
+Graph::Graph(const Graph& graph)
+{
+   *this = graph;
+}
+
+void Graph::operator=(const Graph& graph)
+{
+   _offsets = graph._offsets;
+   _targets = graph._targets;
+   _lengths = graph._lengths;
+   _points = graph._points;
+}
+
+void Graph::throwOnInvalidVertex(uint vertex) const
+{
+   if (vertex >= _points.size())
+      throw std::invalid_argument(
+        "Graph: vertex number " + std::to_string(vertex) +
+        " is out of range (vertices count is " +
+        std::to_string(_points.size()) + ")");
+}
+
+void Graph::buildAdjacency(const edge_list_t& edges)
+{
+   const size_t n = _points.size();
+   _offsets.assign(n + 1, 0);
+   for (auto&& edge : edges) {
+      throwOnInvalidVertex(edge.first);
+      throwOnInvalidVertex(edge.second);
+      if (edge.first == edge.second)
+         continue;
+      ++_offsets[edge.first + 1];
+      ++_offsets[edge.second + 1];
+   }
+   for (size_t v = 0; v < n; ++v)
+      _offsets[v + 1] += _offsets[v];
+
+   _targets.resize(_offsets[n]);
+   std::vector<size_t> cursor(_offsets.begin(), _offsets.end() - 1);
+   for (auto&& edge : edges) {
+      if (edge.first == edge.second)
+         continue;
+      _targets[cursor[edge.first]++] = edge.second;
+      _targets[cursor[edge.second]++] = edge.first;
+   }
+
+   // Sort every row and compact it in place, dropping duplicates
+   size_t write = 0;
+   for (size_t v = 0; v < n; ++v) {
+      const size_t begin = _offsets[v], end = _offsets[v + 1];
+      std::sort(_targets.begin() + begin, _targets.begin() + end);
+      _offsets[v] = write;
+      for (size_t i = begin; i < end; ++i)
+         if (i == begin || _targets[i] != _targets[i - 1])
+            _targets[write++] = _targets[i];
+   }
+   _offsets[n] = write;
+   _targets.resize(write);
+   _targets.shrink_to_fit();
+   computeLengths();
+}
+
+void Graph::computeLengths()
+{
+   const size_t n = _points.size();
+   _lengths.resize(_targets.size());
+   impl::parallelFor(0, n, 4096, [this](size_t begin, size_t end) {
+      for (size_t v = begin; v < end; ++v)
+         for (size_t i = _offsets[v]; i < _offsets[v + 1]; ++i)
+            _lengths[i] =
+              Point::distance(_points[v]._p, _points[_targets[i]]._p);
+   });
+}
+
+size_t Graph::size() const
+{
+   return _points.size();
+}
+
+Graph::Neighbours Graph::neighbours(uint vertex) const
+{
+   throwOnInvalidVertex(vertex);
+   return Neighbours(_targets.data() + _offsets[vertex],
+                     _targets.data() + _offsets[vertex + 1]);
+}
+
+const Point& Graph::point(uint vertex) const
+{
+   throwOnInvalidVertex(vertex);
+   return _points[vertex]._p;
+}
+
+bool Graph::isAdjacent(uint a, uint b) const
+{
+   Neighbours row = neighbours(a);
+   return std::binary_search(row.begin(), row.end(), b);
+}
+
+const matrix_t Graph::getAdjacencyMatrix() const
+{
+   matrix_t result(size(), std::vector<int>(size(), 0));
+   for (uint v = 0; v < size(); ++v)
+      for (uint u : neighbours(v))
+         result[v][u] = 1;
+   return result;
+}
+
+edge_list_t Graph::getEdgeList() const
+{
+   edge_list_t result;
+   result.reserve(edgesCount());
+   for (uint v = 0; v < size(); ++v)
+      for (uint u : neighbours(v))
+         if (v < u)
+            result.push_back({ v, u });
+   return result;
+}
+
+void Graph::print() const
+{
+   for (uint v = 0; v < size(); ++v) {
+      std::cout << v << " " << _points[v]._p << ":";
+      for (uint u : neighbours(v))
+         std::cout << " " << u;
+      std::cout << std::endl;
+   }
+}
+
+bool Graph::validate() const
+{
+   const size_t n = size();
+   if (n == 0)
+      return _offsets.size() <= 1 && _targets.empty();
+   if (_offsets.size() != n + 1 || _offsets[0] != 0 || _offsets[n] != _targets.size())
+      return false;
+
+   for (uint v = 0; v < n; ++v) {
+      if (_offsets[v] > _offsets[v + 1] ||
+          Point::isAtInfinity(_points[v]._p))
+         return false;
+      for (size_t i = _offsets[v]; i < _offsets[v + 1]; ++i) {
+         const uint u = _targets[i];
+         if (u >= n || u == v)
+            return false;
+         if (i > _offsets[v] && _targets[i - 1] >= u)
+            return false;
+         if (!isAdjacent(u, v))
+            return false;
+      }
+   }
+   return true;
+}
+
+Graph Graph::getSpanningTree(Method m) const
+{
+   GEOMETRY_TIMER("Graph::getSpanningTree");
+   std::vector<Point> points(size());
+   for (uint v = 0; v < size(); ++v)
+      points[v] = _points[v]._p;
+
+   switch (m) {
+      case Method::BY_DEPTH:
+         return Graph(spanningTreeByDepth(), points);
+      case Method::BY_WIDTH:
+         return Graph(spanningTreeByWidth(), points);
+      case Method::MINIMUM:
+         return Graph(minimumSpanningTree(), points);
+      default:
+         break;
+   }
+   throw std::invalid_argument(
+     "Graph::getSpanningTree: unknown method");
+}
+
+edge_list_t Graph::spanningTreeByDepth() const
+{
+   edge_list_t result;
+   std::vector<bool> visited(size(), false);
+   /**
+    * @brief Stack of pairs (vertex, position of the next neighbour
+    * to check in _targets)
+    */
+   std::vector<std::pair<uint, size_t>> stack;
+
+   for (uint root = 0; root < size(); ++root) {
+      if (visited[root])
+         continue;
+      visited[root] = true;
+      stack.push_back({ root, _offsets[root] });
+      while (!stack.empty()) {
+         auto& top = stack.back();
+         if (top.second == _offsets[top.first + 1]) {
+            stack.pop_back();
+            continue;
+         }
+         const uint next = _targets[top.second++];
+         if (!visited[next]) {
+            visited[next] = true;
+            result.push_back({ top.first, next });
+            stack.push_back({ next, _offsets[next] });
+         }
+      }
+   }
+   return result;
+}
+
+edge_list_t Graph::spanningTreeByWidth() const
+{
+   edge_list_t result;
+   std::vector<bool> visited(size(), false);
+   std::vector<uint> queue;
+   queue.reserve(size());
+
+   for (uint root = 0; root < size(); ++root) {
+      if (visited[root])
+         continue;
+      visited[root] = true;
+      queue.push_back(root);
+      // queue grows at the back, `head` points to the front
+      for (size_t head = queue.size() - 1; head < queue.size();
+           ++head) {
+         const uint v = queue[head];
+         for (uint u : neighbours(v))
+            if (!visited[u]) {
+               visited[u] = true;
+               result.push_back({ v, u });
+               queue.push_back(u);
+            }
+      }
+   }
+   return result;
+}
+
+namespace impl {
+   /**
+    * @brief Disjoint set union with path halving and union by size
+    */
+   class DisjointSets
+   {
+     private:
+      std::vector<uint> _parent;
+      std::vector<uint> _size;
+
+     public:
+      DisjointSets(size_t count) : _parent(count), _size(count, 1)
+      {
+         for (uint i = 0; i < count; ++i)
+            _parent[i] = i;
+      }
+      uint find(uint v)
+      {
+         while (_parent[v] != v) {
+            _parent[v] = _parent[_parent[v]];
+            v = _parent[v];
+         }
+         return v;
+      }
+      bool unite(uint a, uint b)
+      {
+         a = find(a), b = find(b);
+         if (a == b)
+            return false;
+         if (_size[a] < _size[b])
+            std::swap(a, b);
+         _parent[b] = a;
+         _size[a] += _size[b];
+         return true;
+      }
+   };
+
+   /**
+    * @brief Candidate edge of Borůvka's round. Edges are compared by
+    * weight, then by vertex numbers, so all weights are distinct and
+    * the result has no cycles.
+    */
+   struct BoruvkaEdge
+   {
+      double weight = std::numeric_limits<double>::infinity();
+      uint from = std::numeric_limits<uint>::max();
+      uint to = std::numeric_limits<uint>::max();
+
+      bool exists() const { return from != to; }
+      bool operator<(const BoruvkaEdge& other) const
+      {
+         if (weight != other.weight)
+            return weight < other.weight;
+         const auto a = std::minmax(from, to),
+                    b = std::minmax(other.from, other.to);
+         return a < b;
+      }
+   };
+} // namespace impl
+
+edge_list_t Graph::minimumSpanningTree() const
+{
+   /**
+    * @brief Vertices per parallel task
+    */
+   const size_t grain = 4096;
+   const size_t n = size();
+   edge_list_t result;
+   if (n == 0)
+      return result;
+
+   impl::DisjointSets components(n);
+   std::vector<uint> label(n);
+   std::vector<impl::BoruvkaEdge> vertex_best(n), component_best(n);
+   bool merged = true;
+   while (merged && result.size() + 1 < n) {
+      merged = false;
+      for (uint v = 0; v < n; ++v)
+         label[v] = components.find(v);
+
+      // Cheapest edge leaving the component, searched per vertex
+      impl::parallelFor(0, n, grain, [&](size_t begin, size_t end) {
+         for (size_t v = begin; v < end; ++v) {
+            impl::BoruvkaEdge best;
+            for (size_t i = _offsets[v]; i < _offsets[v + 1]; ++i) {
+               const uint u = _targets[i];
+               if (label[u] == label[v])
+                  continue;
+               impl::BoruvkaEdge current { _lengths[i],
+                                           static_cast<uint>(v),
+                                           u };
+               if (current < best)
+                  best = current;
+            }
+            vertex_best[v] = best;
+         }
+      });
+
+      std::fill(component_best.begin(),
+                component_best.end(),
+                impl::BoruvkaEdge());
+      for (uint v = 0; v < n; ++v)
+         if (vertex_best[v].exists() &&
+             vertex_best[v] < component_best[label[v]])
+            component_best[label[v]] = vertex_best[v];
+
+      for (uint c = 0; c < n; ++c) {
+         const impl::BoruvkaEdge& edge = component_best[c];
+         if (edge.exists() && components.unite(edge.from, edge.to)) {
+            result.push_back({ edge.from, edge.to });
+            merged = true;
+         }
+      }
+   }
+   return result;
+}
+
+Graph::PathSearch::PathSearch(const Graph& graph) :
+  _graph(graph), _distance(graph.size()), _parent(graph.size()),
+  _reached(graph.size(), 0), _settled(graph.size(), 0),
+  _isTarget(graph.size(), 0)
+{
+   _heap.reserve(graph.size());
+}
+
+void Graph::PathSearch::nextGeneration()
+{
+   if (++_generation == 0) {
+      // Generation counter wrapped around, stamps are not valid now
+      std::fill(_reached.begin(), _reached.end(), 0);
+      std::fill(_settled.begin(), _settled.end(), 0);
+      std::fill(_isTarget.begin(), _isTarget.end(), 0);
+      _generation = 1;
+   }
+   _heap.clear();
+}
+
+void Graph::PathSearch::start(uint from)
+{
+   _graph.throwOnInvalidVertex(from);
+   nextGeneration();
+   _distance[from] = 0;
+   _parent[from] = from;
+   _reached[from] = _generation;
+}
+
+void Graph::PathSearch::relax(uint from, size_t arc, double key_shift)
+{
+   const uint to = _graph._targets[arc];
+   if (_settled[to] == _generation)
+      return;
+   const double distance = _distance[from] + _graph._lengths[arc];
+   if (_reached[to] != _generation || distance < _distance[to]) {
+      _reached[to] = _generation;
+      _distance[to] = distance;
+      _parent[to] = from;
+      _heap.push_back({ distance + key_shift, to });
+      std::push_heap(_heap.begin(), _heap.end(), std::greater<>());
+   }
+}
+
+Graph::Path Graph::PathSearch::find(uint from, uint to, PathMethod m)
+{
+   _graph.throwOnInvalidVertex(to);
+   start(from);
+   const Point& target = _graph._points[to]._p;
+   auto heuristic = [&](uint v) {
+      return (m == A_STAR)
+               ? Point::distance(_graph._points[v]._p, target)
+               : 0.0;
+   };
+
+   _heap.push_back({ heuristic(from), from });
+   while (!_heap.empty()) {
+      std::pop_heap(_heap.begin(), _heap.end(), std::greater<>());
+      const uint v = _heap.back().second;
+      _heap.pop_back();
+      if (_settled[v] == _generation)
+         continue; // outdated heap entry
+      _settled[v] = _generation;
+      if (v == to)
+         break;
+      for (size_t i = _graph._offsets[v]; i < _graph._offsets[v + 1];
+           ++i)
+         relax(v, i, heuristic(_graph._targets[i]));
+   }
+
+   Path result { std::numeric_limits<double>::infinity(), {} };
+   if (_settled[to] != _generation)
+      return result;
+   result.length = _distance[to];
+   for (uint v = to; v != from; v = _parent[v])
+      result.vertices.push_back(v);
+   result.vertices.push_back(from);
+   std::reverse(result.vertices.begin(), result.vertices.end());
+   return result;
+}
+
+Graph::Path Graph::PathSearch::find(const Point& from,
+                                    const std::vector<uint>& sources,
+                                    const Point& to,
+                                    const std::vector<uint>& targets)
+{
+   nextGeneration();
+   for (uint target : targets) {
+      _graph.throwOnInvalidVertex(target);
+      _isTarget[target] = _generation;
+   }
+   auto heuristic = [&](uint v) {
+      return Point::distance(_graph._points[v]._p, to);
+   };
+   for (uint source : sources) {
+      _graph.throwOnInvalidVertex(source);
+      const double distance =
+        Point::distance(from, _graph._points[source]._p);
+      if (_reached[source] != _generation ||
+          distance < _distance[source]) {
+         _reached[source] = _generation;
+         _distance[source] = distance;
+         _parent[source] = source;
+         _heap.push_back({ distance + heuristic(source), source });
+         std::push_heap(_heap.begin(), _heap.end(), std::greater<>());
+      }
+   }
+
+   // The heuristic is the length of the arc to `to`, so the key of the
+   // first settled target is the length of the whole path
+   const uint none = std::numeric_limits<uint>::max();
+   uint last = none;
+   while (!_heap.empty()) {
+      std::pop_heap(_heap.begin(), _heap.end(), std::greater<>());
+      const uint v = _heap.back().second;
+      _heap.pop_back();
+      if (_settled[v] == _generation)
+         continue; // outdated heap entry
+      _settled[v] = _generation;
+      if (_isTarget[v] == _generation) {
+         last = v;
+         break;
+      }
+      for (size_t i = _graph._offsets[v]; i < _graph._offsets[v + 1];
+           ++i)
+         relax(v, i, heuristic(_graph._targets[i]));
+   }
+
+   Path result { std::numeric_limits<double>::infinity(), {} };
+   if (last == none)
+      return result;
+   result.length = _distance[last] + heuristic(last);
+   uint v = last;
+   for (; _parent[v] != v; v = _parent[v])
+      result.vertices.push_back(v);
+   result.vertices.push_back(v);
+   std::reverse(result.vertices.begin(), result.vertices.end());
+   return result;
+}
+
+void Graph::PathSearch::distances(uint from,
+                                  const std::vector<uint>& targets,
+                                  std::vector<double>& result)
+{
+   start(from);
+   size_t remained = 0;
+   for (uint target : targets) {
+      _graph.throwOnInvalidVertex(target);
+      if (_isTarget[target] != _generation) {
+         _isTarget[target] = _generation;
+         ++remained;
+      }
+   }
+
+   _heap.push_back({ 0.0, from });
+   while (!_heap.empty() && remained != 0) {
+      std::pop_heap(_heap.begin(), _heap.end(), std::greater<>());
+      const uint v = _heap.back().second;
+      _heap.pop_back();
+      if (_settled[v] == _generation)
+         continue; // outdated heap entry
+      _settled[v] = _generation;
+      if (_isTarget[v] == _generation)
+         --remained;
+      for (size_t i = _graph._offsets[v]; i < _graph._offsets[v + 1];
+           ++i)
+         relax(v, i, 0.0);
+   }
+
+   result.resize(targets.size());
+   for (size_t i = 0; i < targets.size(); ++i)
+      result[i] = (_settled[targets[i]] == _generation)
+                    ? _distance[targets[i]]
+                    : std::numeric_limits<double>::infinity();
+}
+
+Graph::Path Graph::shortestPath(uint from, uint to, PathMethod m) const
+{
+   GEOMETRY_TIMER("Graph::shortestPath");
+   PathSearch search(*this);
+   return search.find(from, to, m);
+}
+
+std::vector<std::vector<double>> Graph::shortestDistances(
+  const std::vector<uint>& sources,
+  const std::vector<uint>& targets) const
+{
+   GEOMETRY_TIMER("Graph::shortestDistances");
+   std::vector<std::vector<double>> result(sources.size());
+   // Chunks take a search from the pool and return it, so at most one
+   // PathSearch per running thread is allocated
+   std::mutex mutex;
+   std::vector<std::unique_ptr<PathSearch>> pool;
+   impl::parallelFor(
+     0, sources.size(), 1, [&](size_t begin, size_t end) {
+        std::unique_ptr<PathSearch> search;
+        {
+           std::lock_guard<std::mutex> lock(mutex);
+           if (!pool.empty()) {
+              search = std::move(pool.back());
+              pool.pop_back();
+           }
+        }
+        if (!search)
+           search = std::make_unique<PathSearch>(*this);
+        for (size_t i = begin; i < end; ++i)
+           search->distances(sources[i], targets, result[i]);
+        std::lock_guard<std::mutex> lock(mutex);
+        pool.push_back(std::move(search));
+     });
+   return result;
+}
+
+namespace impl {
+   /**
+    * @brief Cursor over graph text in memory
+    */
+   class GraphText
+   {
+     private:
+      const char* const _begin;
+      const char* _current;
+      const char* const _end;
+      /**
+       * @brief Start of the last token read
+       */
+      const char* _token;
+
+     public:
+      GraphText(const char* text, size_t size) :
+        _begin(text), _current(text), _end(text + size), _token(text)
+      {
+      }
+
+      size_t offset() const { return _current - _begin; }
+      size_t remaining() const { return _end - _current; }
+      size_t linesCount() const
+      {
+         return std::count(_current, _end, '\n') + 1;
+      }
+      [[noreturn]] void fail(const std::string& message) const
+      {
+         throw std::runtime_error("Graph: " + message + " at offset " +
+                                  std::to_string(offset()));
+      }
+      /**
+       * @brief Like fail, with the offset of the last token read
+       */
+      [[noreturn]] void failAtToken(const std::string& message)
+      {
+         _current = _token;
+         fail(message);
+      }
+      /**
+       * @brief Skips whitespace and parses the next number, a leading
+       * '+' is accepted as by operator>>
+       * @return false (the cursor stays at the token) if it is not a
+       * number of type T
+       */
+      template<class T>
+      bool tryRead(T& value)
+      {
+         while (_current != _end &&
+                std::isspace(static_cast<unsigned char>(*_current)))
+            ++_current;
+         _token = _current;
+         const char* first = _current;
+         if (first != _end && *first == '+')
+            ++first;
+         const auto [last, error] = std::from_chars(first, _end, value);
+         if (error != std::errc())
+            return false;
+         _current = last;
+         return true;
+      }
+      template<class T>
+      T read(const char* what)
+      {
+         T value;
+         if (!tryRead(value))
+            fail(std::string("expected ") + what);
+         return value;
+      }
+      /**
+       * @brief Reads a finite coordinate; inf and nan are accepted by
+       * std::from_chars, but not by Graph
+       */
+      double readCoordinate()
+      {
+         const double result = read<double>("coordinate");
+         if (!std::isfinite(result))
+            failAtToken("coordinate is not finite");
+         return result;
+      }
+      /**
+       * @brief Reads a vertex number less than `count`
+       */
+      uint readVertex(size_t count)
+      {
+         const uint result = read<uint>("vertex number");
+         if (result >= count)
+            failAtToken("vertex number " + std::to_string(result) +
+                        " is out of range");
+         return result;
+      }
+   };
+
+   /**
+    * @brief Numbers distinct coordinates in order of first appearance.
+    * Open addressing with linear probing over flat arrays; coordinates
+    * are compared by bits, with -0.0 taken as 0.0.
+    */
+   class CoordinatesIndex
+   {
+     private:
+      /**
+       * @brief Number + 1 of the coordinates in the slot, 0 if empty
+       */
+      std::vector<uint> _slots;
+      std::vector<std::pair<uint64_t, uint64_t>> _keys;
+
+      static uint64_t bits(double value)
+      {
+         value += 0.0;
+         uint64_t result;
+         std::memcpy(&result, &value, sizeof(result));
+         return result;
+      }
+      size_t slot(const std::pair<uint64_t, uint64_t>& key) const
+      {
+         uint64_t h = key.first * 0x9e3779b97f4a7c15 ^ key.second;
+         h *= 0xff51afd7ed558ccd;
+         return (h ^ (h >> 32)) & (_slots.size() - 1);
+      }
+      void resize(size_t slots_count)
+      {
+         _slots.assign(slots_count, 0);
+         for (uint i = 0; i < _keys.size(); ++i) {
+            size_t s = slot(_keys[i]);
+            while (_slots[s] != 0)
+               s = (s + 1) & (_slots.size() - 1);
+            _slots[s] = i + 1;
+         }
+      }
+
+     public:
+      explicit CoordinatesIndex(size_t capacity)
+      {
+         size_t slots_count = 16;
+         while (slots_count < 2 * capacity)
+            slots_count *= 2;
+         _keys.reserve(capacity);
+         resize(slots_count);
+      }
+      size_t size() const { return _keys.size(); }
+      /**
+       * @return number of the coordinates, equal to size() before the
+       * call if they are new
+       */
+      uint find(double x, double y)
+      {
+         const std::pair<uint64_t, uint64_t> key(bits(x), bits(y));
+         size_t s = slot(key);
+         for (; _slots[s] != 0; s = (s + 1) & (_slots.size() - 1))
+            if (_keys[_slots[s] - 1] == key)
+               return _slots[s] - 1;
+         if (_keys.size() == std::numeric_limits<uint>::max() - 1)
+            throw std::runtime_error("Graph: too many vertices");
+         _keys.push_back(key);
+         _slots[s] = _keys.size();
+         // Load factor is kept at most 1/2
+         if (2 * _keys.size() > _slots.size())
+            resize(2 * _slots.size());
+         return _keys.size() - 1;
+      }
+   };
+} // namespace impl
+
+Graph Graph::parse(const char* text, size_t size, TextFormat format,
+                   size_t* used)
+{
+   GEOMETRY_TIMER("Graph::parse");
+   impl::GraphText input(text, size);
+   std::vector<Point> points;
+   edge_list_t edges;
+
+   if (format == EDGE_LIST) {
+      const size_t vertices_count = input.read<size_t>("vertices count");
+      const size_t edges_count = input.read<size_t>("edges count");
+      if (vertices_count > std::numeric_limits<uint>::max())
+         input.fail("too many vertices");
+      // Each number takes at least two characters, so counts of a
+      // malformed header cannot cause a huge allocation
+      const size_t limit = input.remaining() / 4 + 1;
+      points.reserve(std::min(vertices_count, limit));
+      edges.reserve(std::min(edges_count, limit));
+      for (size_t i = 0; i < vertices_count; ++i) {
+         const double x = input.readCoordinate();
+         const double y = input.readCoordinate();
+         points.emplace_back(x, y);
+      }
+      for (size_t i = 0; i < edges_count; ++i) {
+         const uint u = input.readVertex(vertices_count);
+         const uint v = input.readVertex(vertices_count);
+         edges.emplace_back(u, v);
+      }
+   } else {
+      const size_t lines = input.linesCount();
+      impl::CoordinatesIndex numbers(lines);
+      points.reserve(lines);
+      edges.reserve(lines);
+      auto vertex = [&](double x, double y) {
+         const size_t count = numbers.size();
+         const uint number = numbers.find(x, y);
+         if (numbers.size() != count)
+            points.emplace_back(x, y);
+         return number;
+      };
+      double x1;
+      while (input.tryRead(x1)) {
+         if (!std::isfinite(x1))
+            input.failAtToken("coordinate is not finite");
+         const double y1 = input.readCoordinate();
+         const double x2 = input.readCoordinate();
+         const double y2 = input.readCoordinate();
+         const uint u = vertex(x1, y1);
+         edges.emplace_back(u, vertex(x2, y2));
+      }
+   }
+
+   if (used != nullptr)
+      *used = input.offset();
+   return Graph(edges, std::move(points));
+}
+
+Graph Graph::load(const std::string& path, TextFormat format)
+{
+   const MappedFile file(path);
+   file.adviseSequential();
+   return parse(reinterpret_cast<const char*>(file.data()), file.size(),
+                format);
+}
+
+namespace impl {
+   /**
+    * @brief Reads EDGE_LIST token by token, for streams which cannot
+    * seek back after reading ahead
+    *
+    * @return false if the input is malformed
+    */
+   bool readEdgeList(std::istream& input, std::vector<Point>& points,
+                     edge_list_t& edges)
+   {
+      size_t vertices_count, edges_count;
+      if (!(input >> vertices_count >> edges_count) ||
+          vertices_count > std::numeric_limits<uint>::max())
+         return false;
+      double x, y;
+      for (size_t i = 0; i < vertices_count; ++i) {
+         if (!(input >> x >> y) || !std::isfinite(x) || !std::isfinite(y))
+            return false;
+         points.emplace_back(x, y);
+      }
+      uint u, v;
+      for (size_t i = 0; i < edges_count; ++i) {
+         if (!(input >> u >> v) || u >= vertices_count ||
+             v >= vertices_count)
+            return false;
+         edges.emplace_back(u, v);
+      }
+      return true;
+   }
+} // namespace impl
+
+std::istream& operator>>(std::istream& input, Graph& graph)
+{
+   const std::istream::sentry sentry(input);
+   if (!sentry)
+      return input;
+   const std::istream::pos_type start = input.tellg();
+   if (start == std::istream::pos_type(-1)) {
+      std::vector<Point> points;
+      edge_list_t edges;
+      if (impl::readEdgeList(input, points, edges))
+         graph = Graph(edges, std::move(points));
+      else
+         input.setstate(std::ios::failbit);
+      return input;
+   }
+
+   std::ostringstream buffer;
+   buffer << input.rdbuf();
+   const std::string text = buffer.str();
+   size_t used = 0;
+   bool is_valid = true;
+   try {
+      graph = Graph::parse(text.data(), text.size(), Graph::EDGE_LIST,
+                           &used);
+   } catch (const std::runtime_error&) {
+      is_valid = false;
+   }
+   // Text after the graph is left for next reads; malformed input is
+   // not consumed
+   input.seekg(start + std::streamoff(is_valid ? used : 0));
+   if (!is_valid)
+      input.setstate(std::ios::failbit);
+   return input;
 }
 
 template<typename T1, typename T2>
@@ -72,11 +991,12 @@ bool Graph::isOnLeft(const Point& p, const LineSegment& edge)
 std::unique_ptr<Polygon> Graph::localizationOfAPoint(
   const Point& p) const
 {
+    GEOMETRY_TIMER("Graph::localizationOfAPoint");
     std::unique_ptr<Polygon> ans = std::unique_ptr<Polygon>(nullptr);
     std::vector<NumberedPoint> points(_points);
     std::sort(points.begin(),
               points.end(),
-              [](NumberedPoint a, NumberedPoint b) {
+              [](const NumberedPoint& a, const NumberedPoint& b) {
                  return !isZero(a._p["y"] - b._p["y"]) &&
                         a._p["y"] < b._p["y"];
               });
@@ -94,10 +1014,14 @@ std::unique_ptr<Polygon> Graph::localizationOfAPoint(
                 points[horizontal_range->second]._p + Point(1, 0))
         };
         Point endpoints[2];
+        // Position of each vertex in `points`
+        std::vector<int> order(points.size());
+        for (i = 0; i < points.size(); i++)
+           order[points[i]._numder] = i;
         for (i = 0; i <= horizontal_range->first; i++)
-           for (j = horizontal_range->second; j < points.size(); j++)
-              if (_adjacencyMatrix[points[i]._numder]
-                                  [points[j]._numder] == 1) {
+           for (uint neighbour : neighbours(points[i]._numder))
+              if (order[neighbour] >= horizontal_range->second) {
+                 j = order[neighbour];
                  l = Line(points[i]._p, points[j]._p);
                  endpoints[0] = Line::intersect(l, l_horizontal[0]);
                  endpoints[1] = Line::intersect(l, l_horizontal[1]);
@@ -106,7 +1030,7 @@ std::unique_ptr<Polygon> Graph::localizationOfAPoint(
 
         std::sort(edges.begin(),
                   edges.end(),
-                  [](LineSegment a, LineSegment b) {
+                  [](const LineSegment& a, const LineSegment& b) {
                      return a.getBegin()["x"] < b.getBegin()["x"] ||
                             a.getEnd()["x"] < b.getEnd()["x"];
                   });
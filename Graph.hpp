@@ -6,20 +6,70 @@
 #include <vector>
 #include <iostream>
 #include <memory>
+#include <string>
 #include "Point.hpp"
 #include "Polygon.hpp"
+#include "Vector2.hpp"
 #include "functions.hpp"
 
 using matrix_t = std::vector<std::vector<int>>;
+/**
+ * @brief List of undirected edges, each edge is a pair of vertex
+ * numbers
+ */
+using edge_list_t = std::vector<std::pair<uint, uint>>;
 
+/**
+ * @brief Undirected graph with vertices placed on the plane.
+ *
+ * Adjacency is stored in compressed sparse row (CSR) form: neighbours
+ * of the vertex v are _targets[_offsets[v]] ..
+ * _targets[_offsets[v + 1] - 1], sorted by vertex number. Memory usage
+ * is O(V + E).
+ */
 class Graph
 {
   private:
    struct NumberedPoint;
 
-   matrix_t _adjacencyMatrix;
+   /**
+    * @brief Row offsets, size is vertices count + 1
+    */
+   std::vector<size_t> _offsets;
+   /**
+    * @brief Concatenated sorted neighbour lists of all vertices
+    */
+   std::vector<uint> _targets;
+   /**
+    * @brief Euclidean length of each arc, parallel to _targets
+    */
+   std::vector<double> _lengths;
    std::vector<NumberedPoint> _points;
 
+   /**
+    * @brief Builds CSR adjacency by undirected edges. Self-loops and
+    * duplicate edges are dropped. `_points` must be filled before call.
+    */
+   void buildAdjacency(const edge_list_t& edges);
+   /**
+    * @brief Fills `_lengths` by `_points` and CSR arrays
+    */
+   void computeLengths();
+   void throwOnInvalidVertex(uint vertex) const;
+
+   friend class GeometryFile;
+   /**
+    * @brief Graph by ready CSR arrays: rows are sorted and unique,
+    * adjacency is symmetric (not checked). Arc lengths are computed
+    * from `points` directly.
+    */
+   Graph(const Vector2* points, size_t count, std::vector<size_t> offsets,
+         std::vector<uint> targets);
+
+   edge_list_t spanningTreeByDepth() const;
+   edge_list_t spanningTreeByWidth() const;
+   edge_list_t minimumSpanningTree() const;
+
    template<typename T1, typename T2>
    static std::unique_ptr<std::pair<int, int>> binSearch(
      const T1& t1, const std::vector<T2>& t2,
@@ -31,21 +81,230 @@ class Graph
    enum Method
    {
       BY_DEPTH,
-      BY_WIDTH
+      BY_WIDTH,
+      /**
+       * @brief Euclidean minimum spanning tree, edge weight is the
+       * distance between its vertices (Borůvka's algorithm)
+       */
+      MINIMUM
+   };
+   enum PathMethod
+   {
+      DIJKSTRA,
+      /**
+       * @brief A* search, distance to the target is the heuristic
+       */
+      A_STAR
+   };
+   /**
+    * @brief Path between two vertices
+    */
+   struct Path
+   {
+      /**
+       * @brief Sum of edge lengths, infinity if there is no path
+       */
+      double length;
+      /**
+       * @brief Vertex numbers from source to target, empty if there is
+       * no path
+       */
+      std::vector<uint> vertices;
+   };
+   /**
+    * @brief Preallocated state of shortest path queries. Arrays are
+    * allocated once and invalidated lazily by the query generation
+    * number, so a query touches only vertices it visits. Use one
+    * object per thread.
+    */
+   class PathSearch
+   {
+     private:
+      const Graph& _graph;
+      std::vector<double> _distance;
+      std::vector<uint> _parent;
+      /**
+       * @brief Generation of the last query which reached the vertex
+       */
+      std::vector<uint> _reached;
+      /**
+       * @brief Generation of the last query which settled the vertex
+       */
+      std::vector<uint> _settled;
+      std::vector<uint> _isTarget;
+      uint _generation = 0;
+      std::vector<std::pair<double, uint>> _heap;
+
+      /**
+       * @brief Starts a new query: invalidates stamps of the previous
+       * one and clears the heap
+       */
+      void nextGeneration();
+      void start(uint from);
+      void relax(uint from, size_t arc, double key_shift);
+
+     public:
+      PathSearch(const Graph& graph);
+
+      /**
+       * @brief Find shortest path between two vertices
+       */
+      Path find(uint from, uint to, PathMethod m = A_STAR);
+      /**
+       * @brief A* search between points which are not vertices of the
+       * graph. `from` is joined by straight arcs to `sources` and
+       * `targets` are joined to `to`; the graph is not modified.
+       *
+       * @return length includes the arcs to `from` and `to`, vertices
+       * are the graph vertices between them
+       */
+      Path find(const Point& from, const std::vector<uint>& sources,
+                const Point& to, const std::vector<uint>& targets);
+      /**
+       * @brief Computes distances from one vertex to many. Search stops
+       * when all targets are settled.
+       *
+       * @param result distances in order of `targets`, infinity for
+       * unreachable ones
+       */
+      void distances(uint from, const std::vector<uint>& targets,
+                     std::vector<double>& result);
+   };
+   /**
+    * @brief Read-only range of neighbours of a vertex (a view into
+    * the CSR storage, no copy)
+    */
+   class Neighbours
+   {
+     private:
+      const uint* _begin;
+      const uint* _end;
+
+     public:
+      Neighbours(const uint* begin, const uint* end) :
+        _begin(begin), _end(end)
+      {
+      }
+      const uint* begin() const { return _begin; }
+      const uint* end() const { return _end; }
+      size_t size() const { return _end - _begin; }
+      uint operator[](size_t index) const { return _begin[index]; }
    };
 
-   // Graph();
+   Graph();
+   /**
+    * @brief Construct a new Graph object by adjacency matrix. Any
+    * non-zero element `adjacencyMatrix[i][j]` is the edge {i, j}.
+    */
    Graph(const matrix_t& adjacencyMatrix, std::vector<Point> points);
-   //  Graph(const List1D<List1D<int>> adjacencyList);
+   /**
+    * @brief Construct a new Graph object by edge list
+    *
+    * @param edges undirected edges, vertex numbers are indices in
+    * `points`
+    * @param points coordinates of vertices
+    */
+   Graph(const edge_list_t& edges, std::vector<Point> points);
+   Graph(const Graph& graph);
 
    void operator=(const Graph& graph);
 
-   //  List1D<List1D<int>> getAdjacencyList() const;
+   size_t size() const;
+   size_t edgesCount() const { return _targets.size() / 2; }
+   Neighbours neighbours(uint vertex) const;
+   const Point& point(uint vertex) const;
+   bool isAdjacent(uint a, uint b) const;
+
+   /**
+    * @brief Get dense adjacency matrix of `this` graph. Requires
+    * O(V^2) memory, use only for small graphs.
+    */
    const matrix_t getAdjacencyMatrix() const;
+   /**
+    * @brief Get edge list of `this` graph, each edge is listed once
+    * as {lesser number, greater number}
+    */
+   edge_list_t getEdgeList() const;
+   /**
+    * @brief Get spanning tree of `this` graph. Traversals are
+    * iterative, so depth of the graph is not limited by the call
+    * stack. For disconnected graph the spanning forest is returned.
+    *
+    * @param m method to use
+    * @return Graph with the same vertices and tree edges
+    */
    Graph getSpanningTree(Method m) const;
+   /**
+    * @brief Find shortest path between two vertices, edge length is
+    * the distance between its vertices. For repeated queries prefer
+    * PathSearch, which keeps its state between calls.
+    */
+   Path shortestPath(uint from, uint to, PathMethod m = A_STAR) const;
+   /**
+    * @brief Many-to-many shortest distances. Sources are split between
+    * threads; PathSearch objects are pooled, so at most one is
+    * allocated per thread and reused for all its sources.
+    *
+    * @return result[i][j] is distance from sources[i] to targets[j]
+    */
+   std::vector<std::vector<double>> shortestDistances(
+     const std::vector<uint>& sources,
+     const std::vector<uint>& targets) const;
    void print() const;
+   /**
+    * @brief Checks consistency of `this` graph: rows are sorted and
+    * unique, vertex numbers are in range, there are no self-loops,
+    * adjacency is symmetric and no vertex lies at infinity
+    */
    bool validate() const;
 
+   /**
+    * @brief Text formats of a graph, numbers separated by whitespace
+    */
+   enum TextFormat
+   {
+      /**
+       * @brief Vertices count and edges count, then `x y` coordinates
+       * of each vertex, then `u v` vertex numbers of each edge
+       */
+      EDGE_LIST,
+      /**
+       * @brief `x1 y1 x2 y2` coordinates of endpoints of each edge, up
+       * to the end of text or the first token which is not a number.
+       * Vertices are the distinct endpoints numbered in order of first
+       * appearance.
+       */
+      COORDINATE_LIST
+   };
+
+   /**
+    * @brief Parses graph from text in memory in one pass by
+    * std::from_chars. Vertices and edges are preallocated by the
+    * counts in the header (EDGE_LIST) or by the count of lines
+    * (COORDINATE_LIST).
+    *
+    * @param used if not null, receives the count of characters parsed
+    * @throw std::runtime_error if the text is malformed, a coordinate
+    * is not finite or a vertex number is out of range, with the offset
+    * of the error
+    */
+   static Graph parse(const char* text, size_t size,
+                      TextFormat format = EDGE_LIST,
+                      size_t* used = nullptr);
+   /**
+    * @brief Maps the file at `path` into memory (see MappedFile.hpp)
+    * and parses it, without copying the text
+    */
+   static Graph load(const std::string& path,
+                     TextFormat format = EDGE_LIST);
+
+   /**
+    * @brief Read graph in EDGE_LIST format. A seekable stream is read
+    * to the end in one block, parsed by Graph::parse and positioned
+    * right after the graph; other streams (pipes) are read token by
+    * token, so nothing after the graph is consumed. Malformed input
+    * sets failbit and leaves `graph` unchanged.
+    */
    friend std::istream& operator>>(std::istream& input, Graph& number);
 
    std::unique_ptr<Polygon> localizationOfAPoint(
@@ -0,0 +1,38 @@
+#include "HomogeneousLine.hpp"
+#include "Instrumentation.hpp"
+#include "Parallel.hpp"
+#include "functions.hpp"
+
+#include <algorithm>
+
+bool HomogeneousLine::isOnSameLine(const Vector2& p, const Vector2& q,
+                                   const Vector2& r)
+{
+   const Vector2 pq = q - p, pr = r - p;
+   // Doubled triangle area relative to the squared longest side
+   return std::abs(pq | pr) <= eps * std::max(pq * pq, pr * pr);
+}
+
+void HomogeneousLine::intersect(const HomogeneousLine& line,
+                                const HomogeneousLine* others,
+                                size_t count, Vector2* result)
+{
+   GEOMETRY_TIMER("HomogeneousLine::intersect");
+   GEOMETRY_COUNT(PREDICATE_EVALUATIONS, count);
+   impl::parallelFor(0, count, 4096, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i)
+         result[i] = intersect(line, others[i]);
+   });
+}
+
+void HomogeneousLine::value(const HomogeneousLine& line,
+                            const Vector2* points, size_t count,
+                            double* result)
+{
+   GEOMETRY_TIMER("HomogeneousLine::value");
+   GEOMETRY_COUNT(PREDICATE_EVALUATIONS, count);
+   impl::parallelFor(0, count, 4096, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i)
+         result[i] = line.value(points[i]);
+   });
+}
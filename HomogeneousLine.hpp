@@ -0,0 +1,95 @@
+#ifndef GEOMETRY_LIB_HOMOGENEOUSLINE_HPP
+#define GEOMETRY_LIB_HOMOGENEOUSLINE_HPP
+
+#include <cmath>
+#include <limits>
+
+#include "Vector2.hpp"
+
+/**
+ * @brief Line by equation 'ax + by + c = 0'. Vertical, horizontal and
+ * other lines have the same representation, so operations need no
+ * dispatch by line type. Trivially copyable, (a, b) is the normal and
+ * (b, -a) is the direction of the line.
+ */
+struct HomogeneousLine
+{
+   double a, b, c;
+
+   /**
+    * @brief Line through p and q directed from p to q. The line is
+    * degenerate (a = b = 0) if p == q.
+    */
+   static HomogeneousLine through(const Vector2& p, const Vector2& q)
+   {
+      return { p.y - q.y, q.x - p.x, p | q };
+   }
+
+   /**
+    * @brief Signed value of the equation at p, proportional to the
+    * distance from the line
+    */
+   double value(const Vector2& p) const { return a * p.x + b * p.y + c; }
+   double distance(const Vector2& p) const
+   {
+      return std::abs(value(p)) / std::sqrt(a * a + b * b);
+   }
+   Vector2 normal() const { return { a, b }; }
+   Vector2 direction() const { return { b, -a }; }
+   bool isDegenerate() const { return a == 0 && b == 0; }
+   bool isParallel(const HomogeneousLine& other) const
+   {
+      return a * other.b - other.a * b == 0;
+   }
+
+   /**
+    * @brief Intersection as the cross product of coefficients, without
+    * branches
+    * @return intersection point, or (Inf;Inf) if lines are parallel
+    * or equal
+    */
+   static Vector2 intersect(const HomogeneousLine& first,
+                            const HomogeneousLine& second)
+   {
+      const double x = first.b * second.c - second.b * first.c;
+      const double y = first.c * second.a - second.c * first.a;
+      const double w = first.a * second.b - second.a * first.b;
+      const bool is_parallel = (w == 0);
+      const double inverse = 1 / (is_parallel ? 1 : w);
+      const double infinity = std::numeric_limits<double>::infinity();
+      return { is_parallel ? infinity : x * inverse,
+               is_parallel ? infinity : y * inverse };
+   }
+   /**
+    * @brief Line through p perpendicular to `to`
+    */
+   static HomogeneousLine perpendicular(const HomogeneousLine& to,
+                                        const Vector2& p)
+   {
+      return { to.b, -to.a, to.a * p.y - to.b * p.x };
+   }
+   /**
+    * @brief Are three points collinear, with relative precision eps.
+    * Repeated points are collinear with any point.
+    */
+   static bool isOnSameLine(const Vector2& p, const Vector2& q,
+                            const Vector2& r);
+
+   /**
+    * @brief Intersections of `line` with each of `others`, computed in
+    * parallel by a branchless loop
+    *
+    * @param result count points, (Inf;Inf) for parallel lines
+    */
+   static void intersect(const HomogeneousLine& line,
+                         const HomogeneousLine* others, size_t count,
+                         Vector2* result);
+   /**
+    * @brief Values of the equation of `line` at each point; the sign
+    * tells the side of the line
+    */
+   static void value(const HomogeneousLine& line, const Vector2* points,
+                     size_t count, double* result);
+};
+
+#endif // GEOMETRY_LIB_HOMOGENEOUSLINE_HPP
@@ -0,0 +1,158 @@
+#include "Instrumentation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace impl {
+   /**
+    * @brief Counters of one thread. Only the owner thread writes them, so
+    * relaxed load + store is enough and no locked instruction is executed
+    * on the hot path; snapshot() reads them concurrently.
+    */
+   struct ThreadRecord
+   {
+      std::array<std::atomic<uint64_t>, Instrumentation::COUNTERS_COUNT>
+        counters {};
+      /**
+       * @brief Timers keyed by name pointer, guarded by `mutex`: timers
+       * wrap whole entry points so the lock is uncontended and rare
+       */
+      std::unordered_map<const char*, Instrumentation::TimerStats> timers;
+      std::mutex mutex;
+   };
+
+   class Registry
+   {
+     private:
+      std::mutex _mutex;
+      std::vector<ThreadRecord*> _threads;
+      /**
+       * @brief Accumulated values of finished threads
+       */
+      Instrumentation::Snapshot _retired;
+
+      static void merge(Instrumentation::Snapshot& to, ThreadRecord& from)
+      {
+         for (size_t i = 0; i < Instrumentation::COUNTERS_COUNT; ++i)
+            to.counters[i] +=
+              from.counters[i].load(std::memory_order_relaxed);
+         std::lock_guard<std::mutex> lock(from.mutex);
+         for (auto&& timer : from.timers) {
+            auto& stats = to.timers[timer.first];
+            stats.calls += timer.second.calls;
+            stats.total += timer.second.total;
+         }
+      }
+
+     public:
+      static Registry& instance()
+      {
+         // Never destroyed: thread records may outlive static objects
+         static Registry* registry = new Registry;
+         return *registry;
+      }
+      void attach(ThreadRecord* record)
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+         _threads.push_back(record);
+      }
+      void detach(ThreadRecord* record)
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+         merge(_retired, *record);
+         _threads.erase(
+           std::find(_threads.begin(), _threads.end(), record));
+      }
+      Instrumentation::Snapshot snapshot()
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+         Instrumentation::Snapshot result = _retired;
+         for (ThreadRecord* record : _threads)
+            merge(result, *record);
+         return result;
+      }
+      void reset()
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+         _retired = Instrumentation::Snapshot();
+         for (ThreadRecord* record : _threads) {
+            for (auto&& counter : record->counters)
+               counter.store(0, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> record_lock(record->mutex);
+            record->timers.clear();
+         }
+      }
+   };
+
+   struct ThreadRecordOwner
+   {
+      ThreadRecord record;
+      ThreadRecordOwner() { Registry::instance().attach(&record); }
+      ~ThreadRecordOwner() { Registry::instance().detach(&record); }
+   };
+
+   ThreadRecord& threadRecord()
+   {
+      thread_local ThreadRecordOwner owner;
+      return owner.record;
+   }
+} // namespace impl
+
+Instrumentation::ScopedTimer::ScopedTimer(const char* name) :
+  _name(name), _start(std::chrono::steady_clock::now())
+{
+}
+
+Instrumentation::ScopedTimer::~ScopedTimer()
+{
+   addTime(_name, std::chrono::steady_clock::now() - _start);
+}
+
+void Instrumentation::add(Counter c, uint64_t count)
+{
+   std::atomic<uint64_t>& counter = impl::threadRecord().counters[c];
+   counter.store(counter.load(std::memory_order_relaxed) + count,
+                 std::memory_order_relaxed);
+}
+
+void Instrumentation::addTime(const char* name,
+                              std::chrono::nanoseconds duration)
+{
+   impl::ThreadRecord& record = impl::threadRecord();
+   std::lock_guard<std::mutex> lock(record.mutex);
+   TimerStats& stats = record.timers[name];
+   ++stats.calls;
+   stats.total += duration;
+}
+
+Instrumentation::Snapshot Instrumentation::snapshot()
+{
+   return impl::Registry::instance().snapshot();
+}
+
+void Instrumentation::reset()
+{
+   impl::Registry::instance().reset();
+}
+
+const char* Instrumentation::counterName(Counter c)
+{
+   switch (c) {
+      case POINT_ALLOCATIONS:
+         return "point_allocations";
+      case PREDICATE_EVALUATIONS:
+         return "predicate_evaluations";
+      case ESCAPE_ITERATIONS:
+         return "escape_iterations";
+      case GRID_CELLS_VISITED:
+         return "grid_cells_visited";
+      case CLIPPING_ROUNDS:
+         return "clipping_rounds";
+      default:
+         break;
+   }
+   return "unknown";
+}
@@ -0,0 +1,97 @@
+#ifndef GEOMETRY_LIB_INSTRUMENTATION_HPP
+#define GEOMETRY_LIB_INSTRUMENTATION_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+/**
+ * @brief Optional hot-path counters and timers.
+ *
+ * Library code reports events through GEOMETRY_COUNT and
+ * GEOMETRY_TIMER macros. They expand to nothing unless the library is
+ * configured with -DGEOMETRY_INSTRUMENTATION=ON, so the default build
+ * pays nothing. The snapshot/reset API is always available and returns
+ * zeros in the default build.
+ *
+ * Each thread counts into its own storage, snapshot() sums counters of
+ * all threads, including finished ones.
+ */
+class Instrumentation
+{
+  public:
+   enum Counter
+   {
+      POINT_ALLOCATIONS,     // Point objects constructed
+      PREDICATE_EVALUATIONS, // orientation and inclusion tests
+      ESCAPE_ITERATIONS,     // Mandelbrot and Newton iterations
+      GRID_CELLS_VISITED,    // cells of point localization grids
+      CLIPPING_ROUNDS,       // rounds of segment clipping loops
+      COUNTERS_COUNT
+   };
+   struct TimerStats
+   {
+      uint64_t calls = 0;
+      std::chrono::nanoseconds total { 0 };
+   };
+   struct Snapshot
+   {
+      std::array<uint64_t, COUNTERS_COUNT> counters {};
+      /**
+       * @brief Timer statistics by entry point name
+       */
+      std::map<std::string, TimerStats> timers;
+
+      uint64_t operator[](Counter c) const { return counters[c]; }
+   };
+
+   /**
+    * @brief Measures time from construction to destruction and adds
+    * it to the timer `name`
+    *
+    * @param name string literal, it is not copied
+    */
+   class ScopedTimer
+   {
+     private:
+      const char* _name;
+      std::chrono::steady_clock::time_point _start;
+
+     public:
+      ScopedTimer(const char* name);
+      ~ScopedTimer();
+      ScopedTimer(const ScopedTimer&) = delete;
+      ScopedTimer& operator=(const ScopedTimer&) = delete;
+   };
+
+#ifdef GEOMETRY_INSTRUMENTATION
+   static constexpr bool enabled = true;
+#else
+   static constexpr bool enabled = false;
+#endif
+
+   static void add(Counter c, uint64_t count = 1);
+   static void addTime(const char* name,
+                       std::chrono::nanoseconds duration);
+   static Snapshot snapshot();
+   /**
+    * @brief Zero all counters and timers. Events of threads running
+    * concurrently with reset may be lost.
+    */
+   static void reset();
+   static const char* counterName(Counter c);
+};
+
+#ifdef GEOMETRY_INSTRUMENTATION
+#define GEOMETRY_COUNT(counter, count)                                \
+   Instrumentation::add(Instrumentation::counter, count)
+#define GEOMETRY_TIMER(name)                                          \
+   Instrumentation::ScopedTimer geometry_scoped_timer(name)
+#else
+#define GEOMETRY_COUNT(counter, count) ((void)0)
+#define GEOMETRY_TIMER(name) ((void)0)
+#endif
+
+#endif // GEOMETRY_LIB_INSTRUMENTATION_HPP
@@ -4,52 +4,34 @@
 #include <limits>
 #include <stdexcept>
 
-class Line::LineEquation
-{
-  private:
-   Point _pointA, _pointB;
-   double _k, _b, _x, _y;
-   double xDiff, yDiff;
-   bool _inited = false;
-   LineType type;
-
-   void initByLineType();
-
-  public:
-   LineEquation() {};
-   LineEquation(const Point& a, const Point& b);
-   LineEquation(const ComplexNumber& a, const ComplexNumber& b);
-
-   double K() const { return _k; }
-   double B() const { return _b; }
-
-   double xConst() const { return _x; }
-   double yConst() const { return _y; }
-
-   bool isInited() const { return _inited; }
-
-   LineType getType() const { return type; }
-};
-
-Point intersectEqualType(const Line& first, const Line& second);
-Point intersectSubNormalType(const Line& first, const Line& second);
-
 #pragma region Constructors
-void Line::finishInit(const LineEquation& initedEquation)
+void Line::init(const Vector2& a, const Vector2& b)
 {
-   if (!initedEquation.isInited())
+   if (a == b || std::isinf(a.x) || std::isinf(b.x) || std::isinf(a.y) ||
+       std::isinf(b.y))
       throw std::runtime_error(
-        "Cannot finish line initialization with not inited equation!");
+        "Cannot create line from 2 equal points, or coordinates incorrect (a.e. Inf)");
 
-   _k = initedEquation.K();
-   _b = initedEquation.B();
-   _type = initedEquation.getType();
+   const double yDiff = b.y - a.y;
+   const double xDiff = b.x - a.x;
+   _type = (xDiff == 0)
+             ? LineType::CONST_X
+             : ((yDiff == 0) ? LineType::CONST_Y : LineType::NORMAL);
    switch (_type) {
       case LineType::CONST_X:
-         _x = initedEquation.xConst();
+         // Y may be any, x = const
+         _k = 0;
+         _x = b.x;
          break;
       case LineType::CONST_Y:
-         _y = initedEquation.yConst();
+         // X may be any, y = const
+         _b = 0;
+         _y = b.y;
+         break;
+      case LineType::NORMAL:
+         // Normal line, y = kx + b
+         _k = yDiff / xDiff;
+         _b = (-a.x * yDiff + a.y * xDiff) / xDiff;
          break;
       default:
          break;
@@ -64,25 +46,45 @@ Line::Line(double k, double b) : _k(k), _b(b)
    } else if (k == 0) {
       _type = LineType::CONST_Y;
       _y = b;
+   } else {
+      _type = LineType::NORMAL;
    }
 }
 
 Line::Line(const std::pair<Point, Point>& pair)
 {
-   LineEquation equation = LineEquation(pair.first, pair.second);
-   finishInit(equation);
+   init(Vector2::from(pair.first), Vector2::from(pair.second));
 }
 
 Line::Line(const ComplexNumber& first, const ComplexNumber& second)
 {
-   LineEquation equation = LineEquation(first, second);
-   finishInit(equation);
+   init({ first.Re(), first.Im() }, { second.Re(), second.Im() });
 }
 
 Line::Line(const Line& source)
 {
    *this = source;
 }
+
+Line::Line(const HomogeneousLine& line)
+{
+   if (line.isDegenerate() || std::isinf(line.c))
+      throw std::runtime_error(
+        "Cannot construct line from degenerate equation ax + by + c = 0");
+   if (line.b == 0) {
+      _type = LineType::CONST_X;
+      _k = 0;
+      _x = -line.c / line.a;
+   } else if (line.a == 0) {
+      _type = LineType::CONST_Y;
+      _b = 0;
+      _y = -line.c / line.b;
+   } else {
+      _type = LineType::NORMAL;
+      _k = -line.a / line.b;
+      _b = -line.c / line.b;
+   }
+}
 #pragma endregion
 #pragma region Getters and methods
 double Line::y(double x) const
@@ -141,6 +143,18 @@ bool Line::isInY(double y) const
    }
 }
 
+HomogeneousLine Line::homogeneous() const
+{
+   switch (_type) {
+      case LineType::CONST_X:
+         return { 1, 0, -_x };
+      case LineType::CONST_Y:
+         return { 0, 1, -_y };
+      default:
+         return { _k, -1, _b };
+   }
+}
+
 bool Line::isBelongs(Point point) const
 {
    switch (_type) {
@@ -165,52 +179,15 @@ void Line::operator=(const Line& other)
 
 Line Line::makePerpendicular(const Line& to, const Point& from)
 {
-   /**
-    * @brief Random constant, should be > 0
-    */
-   const unsigned int yDiff = 5;
-
-   switch (to.getType()) {
-      case LineType::CONST_X:
-         // Perpendicular is CONST_Y, y = from.Y
-         return Line { 0, from["y"] };
-      case LineType::CONST_Y:
-         // Perpendicular is CONST_X, x = from.X
-         // We should use constructor by 2 points because y = kx + b
-         // not represent equation x = const
-         return Line { from, Point { from["x"], from["y"] + yDiff } };
-      case LineType::NORMAL:
-         // Perpendicular is NORMAL, k = -1/to.k and 'to' on
-         // perpendicular
-         {
-            const double k = -1 / to.K();
-            const double b = from["y"] + from["x"] / to.K();
-            Line result(k, b);
-            result._type = LineType::NORMAL;
-            return result;
-         }
-      default:
-         return Line(0, 0);
-   }
+   return Line(
+     HomogeneousLine::perpendicular(to.homogeneous(), Vector2::from(from)));
 }
 
 Point Line::intersect(const Line& first, const Line& second)
 {
-
-   if (first._type == second._type) {
-      return intersectEqualType(first, second);
-   } else if (first._type == LineType::NORMAL ||
-              second._type == LineType::NORMAL) {
-      return intersectSubNormalType(first, second);
-   } else {
-      // first is CONST_Y, second is CONST_X or vice versa
-      // Make first is CONST_X
-      Line f { first }, s { second };
-      if (f._type != LineType::CONST_X)
-         Line::swap(f, s);
-
-      return Point { f._x, s._y };
-   }
+   return HomogeneousLine::intersect(first.homogeneous(),
+                                     second.homogeneous())
+     .toPoint();
 }
 
 bool Line::isPerpendicular(const Line& other, double precision) const
@@ -232,15 +209,16 @@ bool Line::isPerpendicular(const Line& other, double precision) const
 bool Line::isOnSameLine(const Point& a, const Point& b,
                         const Point& c)
 {
-   return Line(a, b).isBelongs(c);
+   return HomogeneousLine::isOnSameLine(
+     Vector2::from(a), Vector2::from(b), Vector2::from(c));
 }
 bool Line::isOnSameLine(const ComplexNumber& a,
                         const ComplexNumber& b,
                         const ComplexNumber& c)
 {
-   return isOnSameLine(static_cast<Point>(a),
-                       static_cast<Point>(b),
-                       static_cast<Point>(c));
+   return HomogeneousLine::isOnSameLine({ a.Re(), a.Im() },
+                                        { b.Re(), b.Im() },
+                                        { c.Re(), c.Im() });
 }
 
 void Line::swap(Line& left, Line& right)
@@ -249,96 +227,3 @@ void Line::swap(Line& left, Line& right)
    left = right;
    right = tmp;
 }
-
-#pragma region Implementation
-void Line::LineEquation::initByLineType()
-{
-   switch (type) {
-      case LineType::CONST_X:
-         // Y may be any, x = const
-         _k = 0;
-         _b = std::numeric_limits<double>::infinity();
-         _x = _pointB["x"];
-         break;
-      case LineType::CONST_Y:
-         // X may be any, y = const
-         _k = 0;
-         _b = 0;
-         _y = _pointB["y"];
-         break;
-      case LineType::NORMAL:
-         // Normal line, y = kx + b
-         _k = yDiff / xDiff;
-         _b = (-_pointA["x"] * yDiff + _pointA["y"] * xDiff) / xDiff;
-         break;
-      default:
-         break;
-   }
-}
-
-Line::LineEquation::LineEquation(const ComplexNumber& a,
-                                 const ComplexNumber& b) :
-  LineEquation(static_cast<Point>(a), static_cast<Point>(b))
-{
-}
-
-Line::LineEquation::LineEquation(const Point& a, const Point& b)
-{
-   if (a == b || std::isinf(a["x"]) || std::isinf(b["x"]) ||
-       std::isinf(a["y"]) || std::isinf(b["y"]))
-      throw std::runtime_error(
-        "Cannot create line from 2 equal points, or coordinates incorrect (a.e. Inf)");
-
-   _pointA = a, _pointB = b;
-
-   yDiff = _pointB["y"] - _pointA["y"];
-   xDiff = _pointB["x"] - _pointA["x"];
-   type = (xDiff == 0)
-            ? LineType::CONST_X
-            : ((yDiff == 0) ? LineType::CONST_Y : LineType::NORMAL);
-
-   initByLineType();
-   _inited = true;
-   return;
-}
-
-Point intersectEqualType(const Line& first, const Line& second)
-{
-   switch (first.getType()) {
-      case LineType::CONST_X:
-      case LineType::CONST_Y:
-         return Point { std::numeric_limits<double>::infinity(),
-                        std::numeric_limits<double>::infinity() };
-      case LineType::NORMAL: {
-         const double x =
-           (second.B() - first.B()) / (first.K() - second.K());
-         const double y = second.y(x);
-         return Point { x, y };
-      }
-      default:
-         return Point();
-   }
-}
-
-Point intersectSubNormalType(const Line& first, const Line& second)
-{
-   Line f { first }, s { second };
-   /**
-    * @brief Random constant value
-    */
-   const unsigned int cv = 0;
-
-   // Make first is NORMAL
-   if (f.getType() != LineType::NORMAL)
-      Line::swap(f, s);
-
-   switch (s.getType()) {
-      case LineType::CONST_X:
-         return Point { s.x(cv), f.y(s.x(cv)) };
-      case LineType::CONST_Y:
-         return Point { f.x(s.y(cv)), s.y(cv) };
-      default:
-         return Point();
-   }
-}
-#pragma endregion
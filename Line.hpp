@@ -2,6 +2,7 @@
 #define GEOMETRY_LIB_LINE_HPP
 
 #include "ComplexNumber.hpp"
+#include "HomogeneousLine.hpp"
 #include "Point.hpp"
 #include <tuple>
 
@@ -29,8 +30,7 @@ class Line
    static double getKFromPoints(const Point& a, const Point& b);
    static double getBFromPoints(const Point& a, const Point& b);
 
-   class LineEquation;
-   void finishInit(const LineEquation& initedEquation);
+   void init(const Vector2& a, const Vector2& b);
 
   public:
    Line(double k = 0, double b = 0);
@@ -45,6 +45,10 @@ class Line
     */
    Line(const ComplexNumber& first, const ComplexNumber& second);
    Line(const Line& source);
+   /**
+    * @brief Construct a new Line object from equation 'ax + by + c = 0'
+    */
+   explicit Line(const HomogeneousLine& line);
 
    LineType getType() const { return _type; }
 
@@ -52,6 +56,10 @@ class Line
    double x(double y) const;
    const double& K() const { return _k; }
    const double& B() const { return _b; }
+   /**
+    * @brief Equation of `this` line in form 'ax + by + c = 0'
+    */
+   HomogeneousLine homogeneous() const;
 
    bool isInX(double x) const;
    bool isInY(double y) const;
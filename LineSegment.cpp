@@ -1,11 +1,10 @@
 #include "LineSegment.hpp"
 
+#include "Instrumentation.hpp"
 #include "functions.hpp"
 #include <cmath>
 #include <cstdint>
 
-#include <set>
-
 LineSegment::LineSegment()
 {
    _line = Line();
@@ -88,110 +87,44 @@ LineSegment::~LineSegment()
 bool LineSegment::isIntersection(const Point& p1, const Point& p2,
                                  const Point& p3, const Point& p4)
 {
-   bool c1 = LineSegment::isBelongs(p3, p4, p1);
-   bool c2 = LineSegment::isBelongs(p3, p4, p2);
-   bool c3 = LineSegment::isBelongs(p1, p2, p3);
-   bool c4 = LineSegment::isBelongs(p1, p2, p4);
-   if (c1 || c2 || c3 || c4)
-      return true;
-
-   double cros_prod1 = (p3 - p1) | (p2 - p1);
-   double cros_prod2 = (p2 - p1) | (p4 - p1);
-   double cros_prod3 = (p1 - p3) | (p4 - p3);
-   double cros_prod4 = (p4 - p3) | (p2 - p3);
-   if ((sign(cros_prod1) == sign(cros_prod2)) ||
-       (sign(cros_prod3) == sign(cros_prod4)))
-      return true;
-   return false;
+   GEOMETRY_COUNT(PREDICATE_EVALUATIONS, 1);
+   return CompactSegment::isIntersection(
+     CompactSegment::make(Vector2::from(p1), Vector2::from(p2)),
+     CompactSegment::make(Vector2::from(p3), Vector2::from(p4)));
 }
 
 bool LineSegment::isIntersection(const LineSegment& ls) const
 {
-   std::pair<Point, Point> p1 { _endpoints[0], _endpoints[1] };
-   std::pair<Point, Point> p2 { ls._endpoints[0], ls._endpoints[1] };
-   return LineSegment::isIntersection(
-     p1.first, p1.second, p2.first, p2.second);
-}
-
-struct event
-{
-   double x;
-   int tp, id;
-
-   event() {}
-   event(double x, int tp, int id) : x(x), tp(tp), id(id) {}
-
-   bool operator<(const event& e) const
-   {
-      if (abs(x - e.x) > eps)
-         return x < e.x;
-      return tp > e.tp;
-   }
-};
-
-bool operator<(const LineSegment& a, const LineSegment& b)
-{
-   double x = std::max(std::min(a.getBegin()["x"], a.getEnd()["x"]),
-                       std::min(b.getBegin()["x"], b.getEnd()["x"]));
-   return a.getLine().y(x) < b.getLine().y(x) - eps;
+   GEOMETRY_COUNT(PREDICATE_EVALUATIONS, 1);
+   return CompactSegment::isIntersection(compact(), ls.compact());
 }
 
-inline std::set<LineSegment>::iterator prev(
-  std::set<LineSegment>::iterator it, const std::set<LineSegment>& s)
+CompactSegment LineSegment::compact() const
 {
-   return it == s.begin() ? s.end() : --it;
+   return CompactSegment::make(Vector2::from(_endpoints[0]),
+                               Vector2::from(_endpoints[1]));
 }
 
-inline std::set<LineSegment>::iterator next(
-  std::set<LineSegment>::iterator it)
+std::vector<CompactSegment> LineSegment::compact(
+  const std::vector<LineSegment>& vec)
 {
-   return ++it;
+   std::vector<CompactSegment> result;
+   result.reserve(vec.size());
+   for (auto&& ls : vec)
+      result.push_back(ls.compact());
+   return result;
 }
 
 bool LineSegment::isIntersection(const std::vector<LineSegment>& vec)
 {
-   int n = vec.size();
-   std::vector<event> e;
-   for (int i = 0; i < n; ++i) {
-      e.push_back(
-        event(std::min(vec[i].getBegin()["x"], vec[i].getEnd()["x"]),
-              +1,
-              i));
-      e.push_back(
-        event(std::max(vec[i].getBegin()["x"], vec[i].getEnd()["x"]),
-              -1,
-              i));
-   }
-   std::sort(e.begin(), e.end());
-
-   std::set<LineSegment> s = std::set<LineSegment>();
-   std::vector<std::set<LineSegment>::iterator> iters(n);
-
-   for (size_t i = 0; i < e.size(); ++i) {
-      int id = e[i].id;
-      if (e[i].tp == +1) {
-         std::set<LineSegment>::iterator nxt = s.lower_bound(vec[id]),
-                                         prv = prev(nxt, s);
-         if (nxt != s.end() && (*nxt).isIntersection(vec[id]))
-            return true;
-         if (prv != s.end() && (*prv).isIntersection(vec[id]))
-            return true;
-         iters[id] = s.insert(nxt, vec[id]);
-      } else {
-         std::set<LineSegment>::iterator nxt = next(iters[id]),
-                                         prv = prev(iters[id], s);
-         if (nxt != s.end() && prv != s.end() &&
-             (*nxt).isIntersection(*prv))
-            return true;
-         s.erase(iters[id]);
-      }
-   }
-   return false;
+   GEOMETRY_TIMER("LineSegment::isIntersection");
+   return CompactSegment::isAnyIntersection(compact(vec));
 }
 
 bool LineSegment::isBelongs(const Point& p1, const Point& p2,
                             const Point& p)
 {
+   GEOMETRY_COUNT(PREDICATE_EVALUATIONS, 1);
    return isZero(Point::distance(p, p1) + Point::distance(p, p2) -
                  Point::distance(p1, p2));
 }
@@ -1,6 +1,7 @@
 #ifndef GEOMETRY_LIB_LINESEGMENT_HPP
 #define GEOMETRY_LIB_LINESEGMENT_HPP
 
+#include "CompactSegment.hpp"
 #include "Line.hpp"
 
 class LineSegment
@@ -21,6 +22,13 @@ class LineSegment
    Point getPointByY(double y) const;
    Line getLine() const;
    double length() const;
+   /**
+    * @brief Get trivially copyable representation of `this` segment
+    * for intersection kernels
+    */
+   CompactSegment compact() const;
+   static std::vector<CompactSegment> compact(
+     const std::vector<LineSegment>& vec);
 
    /**
     * @brief Move `this` line segment along the specified segment
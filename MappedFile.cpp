@@ -0,0 +1,79 @@
+#include "MappedFile.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace impl {
+   /**
+    * @brief Closes `descriptor` (if it is open) after errno is read
+    */
+   [[noreturn]] void throwFileError(const std::string& message,
+                                    const std::string& path,
+                                    int descriptor = -1)
+   {
+      const std::string error = "MappedFile: " + message + " '" + path +
+                                "' (" + std::strerror(errno) + ")";
+      if (descriptor >= 0)
+         ::close(descriptor);
+      throw std::runtime_error(error);
+   }
+}
+
+MappedFile::MappedFile(const std::string& path)
+{
+   const int descriptor = ::open(path.c_str(), O_RDONLY);
+   if (descriptor < 0)
+      impl::throwFileError("cannot open", path);
+   struct stat status;
+   if (::fstat(descriptor, &status) != 0)
+      impl::throwFileError("cannot get size of", path, descriptor);
+   _size = status.st_size;
+   // mmap of zero bytes fails, an empty file is an empty mapping
+   if (_size > 0) {
+      void* address =
+        ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+      if (address == MAP_FAILED)
+         impl::throwFileError("cannot map", path, descriptor);
+      _data = static_cast<const unsigned char*>(address);
+   }
+   // The mapping stays valid after the descriptor is closed
+   ::close(descriptor);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+  _data(std::exchange(other._data, nullptr)),
+  _size(std::exchange(other._size, 0))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+   if (this != &other) {
+      release();
+      _data = std::exchange(other._data, nullptr);
+      _size = std::exchange(other._size, 0);
+   }
+   return *this;
+}
+
+void MappedFile::release()
+{
+   if (_data)
+      ::munmap(const_cast<unsigned char*>(_data), _size);
+   _data = nullptr;
+   _size = 0;
+}
+
+void MappedFile::adviseSequential() const
+{
+   if (_data)
+      ::madvise(const_cast<unsigned char*>(_data), _size,
+                MADV_SEQUENTIAL);
+}
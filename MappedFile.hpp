@@ -0,0 +1,65 @@
+#ifndef GEOMETRY_LIB_MAPPEDFILE_HPP
+#define GEOMETRY_LIB_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Read-only view of `count` elements stored elsewhere (in a
+ * mapped file or in a vector), no copy
+ */
+template<class T>
+class ArrayView
+{
+  private:
+   const T* _data = nullptr;
+   size_t _size = 0;
+
+  public:
+   ArrayView() = default;
+   ArrayView(const T* data, size_t size) : _data(data), _size(size) {}
+
+   const T* data() const { return _data; }
+   size_t size() const { return _size; }
+   bool empty() const { return _size == 0; }
+   const T* begin() const { return _data; }
+   const T* end() const { return _data + _size; }
+   const T& operator[](size_t index) const { return _data[index]; }
+};
+
+/**
+ * @brief Whole file mapped into memory read-only (POSIX mmap). Pages
+ * are loaded by the OS on first access, so opening is immediate and
+ * the file may be larger than RAM. Move-only; the mapping is released
+ * by the destructor, views into it must not outlive the object.
+ */
+class MappedFile
+{
+  private:
+   const unsigned char* _data = nullptr;
+   size_t _size = 0;
+
+   void release();
+
+  public:
+   MappedFile() = default;
+   /**
+    * @brief Maps the file, throws std::runtime_error if it cannot be
+    * opened or mapped
+    */
+   explicit MappedFile(const std::string& path);
+   MappedFile(MappedFile&& other) noexcept;
+   MappedFile& operator=(MappedFile&& other) noexcept;
+   MappedFile(const MappedFile&) = delete;
+   MappedFile& operator=(const MappedFile&) = delete;
+   ~MappedFile() { release(); }
+
+   const unsigned char* data() const { return _data; }
+   size_t size() const { return _size; }
+   /**
+    * @brief Hints the OS that the file is read from begin to end
+    */
+   void adviseSequential() const;
+};
+
+#endif // GEOMETRY_LIB_MAPPEDFILE_HPP
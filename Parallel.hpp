@@ -0,0 +1,98 @@
+#ifndef GEOMETRY_LIB_PARALLEL_HPP
+#define GEOMETRY_LIB_PARALLEL_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+/**
+ * @brief Parallel loops of batch algorithms.
+ *
+ * Grain policy: a range of `count` elements is split into contiguous
+ * chunks of max(grain, ceil(count / maxChunks)) elements, the last
+ * chunk may be shorter. Chunk boundaries depend only on `count` and
+ * `grain`, not on threads count, so results merged in chunk order (and
+ * per-chunk reductions) are the same for any threads count. Algorithms
+ * choose `grain` so that a chunk takes at least tens of microseconds.
+ *
+ * Chunks run on ThreadPool (or on the external executor), the calling
+ * thread takes part. The first exception thrown by a chunk is rethrown
+ * in the calling thread.
+ */
+namespace impl {
+   /**
+    * @brief Upper limit of chunks count, enough to balance load of
+    * several dozens of threads
+    */
+   const size_t maxChunks = 256;
+
+   inline size_t chunkSize(size_t count, size_t grain)
+   {
+      return std::max<size_t>({ grain,
+                                (count + maxChunks - 1) / maxChunks,
+                                1 });
+   }
+   inline size_t chunksCount(size_t count, size_t grain)
+   {
+      const size_t size = chunkSize(count, grain);
+      return (count + size - 1) / size;
+   }
+
+   /**
+    * @brief Calls `f(chunk, chunk_begin, chunk_end)` for each chunk of
+    * [0, count), chunk is the number of the chunk in
+    * [0, chunksCount(count, grain))
+    */
+   template<class F>
+   void parallelChunks(size_t count, size_t grain, F&& f)
+   {
+      const size_t size = chunkSize(count, grain);
+      ThreadPool::run(chunksCount(count, grain), [&](size_t chunk) {
+         f(chunk, chunk * size, std::min(count, (chunk + 1) * size));
+      });
+   }
+
+   /**
+    * @brief Calls `f(chunk_begin, chunk_end)` for each chunk of
+    * [first, last)
+    */
+   template<class F>
+   void parallelFor(size_t first, size_t last, size_t grain, F&& f)
+   {
+      if (first >= last)
+         return;
+      parallelChunks(
+        last - first, grain, [&](size_t, size_t begin, size_t end) {
+           f(first + begin, first + end);
+        });
+   }
+
+   /**
+    * @brief Parallel map of chunks to vectors, concatenated in chunk
+    * order: `f(begin, end, part)` appends results of [begin, end) to
+    * `part`
+    */
+   template<class T, class F>
+   std::vector<T> parallelCollect(size_t count, size_t grain, F&& f)
+   {
+      std::vector<std::vector<T>> parts(chunksCount(count, grain));
+      parallelChunks(
+        count, grain, [&](size_t chunk, size_t begin, size_t end) {
+           f(begin, end, parts[chunk]);
+        });
+      size_t total = 0;
+      for (auto&& part : parts)
+         total += part.size();
+      std::vector<T> result;
+      result.reserve(total);
+      for (auto&& part : parts) {
+         std::move(part.begin(), part.end(), std::back_inserter(result));
+         std::vector<T>().swap(part);
+      }
+      return result;
+   }
+} // namespace impl
+
+#endif // GEOMETRY_LIB_PARALLEL_HPP
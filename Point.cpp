@@ -1,12 +1,17 @@
 #include "Point.hpp"
+#include "Instrumentation.hpp"
+#include "Parallel.hpp"
 #include "functions.hpp"
 
 #include <cmath>
 #include <limits>
+#include <random>
 #include <sstream>
+#include <stdexcept>
 
 Point::Point(double x, double y)
 {
+   GEOMETRY_COUNT(POINT_ALLOCATIONS, 1);
    _coordinates = std::vector<double>(2);
    _coordinates[0] = x;
    _coordinates[1] = y;
@@ -41,12 +46,14 @@ bool Point::equal(const Point& a, int size) const
 
 Point::Point()
 {
+   GEOMETRY_COUNT(POINT_ALLOCATIONS, 1);
    _coordinates = std::vector<double>(1);
    _coordinates[0] = 0;
 }
 
 Point::Point(int size)
 {
+   GEOMETRY_COUNT(POINT_ALLOCATIONS, 1);
    _coordinates = std::vector<double>(size);
    for (int i = 0; i < size; i++)
       _coordinates[i] = 0;
@@ -54,6 +61,7 @@ Point::Point(int size)
 
 Point::Point(const Point& a)
 {
+   GEOMETRY_COUNT(POINT_ALLOCATIONS, 1);
    *this = a;
 }
 
@@ -308,6 +316,31 @@ Point Point::getRandom(int min, int max, size_t size)
    return result;
 }
 
+std::vector<Point> Point::getRandomCloud(size_t count, int min,
+                                        int max, uint32_t seed,
+                                        size_t size)
+{
+   if (min >= max)
+      throw std::runtime_error(std::to_string(min) + " >= " +
+                               std::to_string(max) +
+                               ". Cannot create random points.");
+   const int scale = 100;
+   std::vector<Point> result(count, Point(int(size)));
+   // Each chunk has own generator seeded by its number
+   impl::parallelChunks(
+     count, 4096, [&](size_t chunk, size_t begin, size_t end) {
+        std::seed_seq seeds { seed, static_cast<uint32_t>(chunk) };
+        std::mt19937 generator(seeds);
+        std::uniform_int_distribution<int> distribution(
+          min * scale, max * scale - 1);
+        for (size_t i = begin; i < end; ++i)
+           for (size_t k = 0; k < size; ++k)
+              result[i][k] =
+                static_cast<double>(distribution(generator)) / scale;
+     });
+   return result;
+}
+
 bool Point::isAtInfinity(const Point& point)
 {
    for (int i = 0; i < point.size(); i++)
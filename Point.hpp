@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <ctype.h>
 #include <iostream>
 #include <vector>
@@ -156,6 +157,16 @@ class Point
     * @return Point
     */
    static Point getRandom(int min, int max, size_t size = 2);
+   /**
+    * @brief Get `count` points with random coordinates, generated in
+    * parallel. Coordinates are from the same range as getRandom, the
+    * result depends only on arguments (not on threads count).
+    *
+    * @param seed seed of pseudo-random generator
+    */
+   static std::vector<Point> getRandomCloud(size_t count, int min,
+                                            int max, uint32_t seed,
+                                            size_t size = 2);
    std::string to_string() const;
 };
 
@@ -1,8 +1,12 @@
 #include "Polygon.hpp"
+#include "FastAngle.hpp"
+#include "Instrumentation.hpp"
 #include "Line.hpp"
+#include "Parallel.hpp"
+#include "Triangulation.hpp"
 #include "functions.hpp"
 
-#include <stack>
+#include <array>
 #include <stdlib.h>
 #include <string>
 
@@ -63,12 +67,24 @@ namespace impl {
        */
       size_t j_min, j_max;
    };
+   /**
+    * @brief Points binned by a grid in CSR form: numbers of input
+    * points of the cell (row, col) are items[offsets[c]] ..
+    * items[offsets[c + 1] - 1], c = row * cols_count + col, in
+    * increasing order
+    */
+   struct GridMatrix
+   {
+      size_t rows_count, cols_count;
+      std::vector<size_t> offsets;
+      std::vector<uint> items;
+   };
    GridMatrixIndices mapInputAreaToGridMatrix(
      const std::pair<std::pair<double, double>,
                      std::pair<double, double>>& input_xy_minmax,
      const std::pair<std::pair<double, double>,
                      std::pair<double, double>>& query_xy_minmax,
-     const std::vector<std::vector<std::stack<Point>>> gridMatrix);
+     const GridMatrix& gridMatrix);
 
    enum class SegmentPosition
    {
@@ -135,7 +151,7 @@ namespace impl {
 
    void throwOnNonSquare(const Polygon& polygon,
                          const std::string& str);
-   std::vector<std::vector<std::stack<Point>>> fillGridMatrix(
+   GridMatrix fillGridMatrix(
      const std::pair<std::pair<double, double>,
                      std::pair<double, double>>& area_xy_minmax,
      const size_t rows_count, const size_t cols_count,
@@ -181,6 +197,7 @@ int Polygon::countIntersections(const Point& p,
 
 int Polygon::intersectionPointIsOnRight(const Point& p, int ind) const
 {
+   GEOMETRY_COUNT(PREDICATE_EVALUATIONS, 1);
    Point inter = Line::intersect(Line((*this)[ind], (*this)[ind + 1]),
                                  Line(p, Point(p["x"] + 1, p["y"])));
    if (std::isinf(inter["x"])) {
@@ -294,6 +311,7 @@ bool Polygon::isInsideConvexPolygon(
 
 bool Polygon::isSimple() const
 {
+   GEOMETRY_TIMER("Polygon::isSimple");
    int i, j;
    for (i = 0; i < size() - 1; i++)
       for (j = i + 2; j < size() - 1; j++)
@@ -310,6 +328,7 @@ bool Polygon::isConvex() const
    int _sign, temp;
    temp = sign(((*this)[1] - (*this)[0]) | ((*this)[2] - (*this)[0]));
    for (int i = 1; i < size() - 1; i++) {
+      GEOMETRY_COUNT(PREDICATE_EVALUATIONS, 1);
       _sign = temp;
       temp = sign(((*this)[i + 1] - (*this)[i]) |
                   ((*this)[i + 2] - (*this)[i]));
@@ -335,6 +354,7 @@ int Polygon::convCoord(int ind, int size)
 bool Polygon::isInsideTriangle(const Point& p1, const Point& p2,
                                const Point& p3, const Point& p)
 {
+   GEOMETRY_COUNT(PREDICATE_EVALUATIONS, 3);
    int sum = 0;
    sum += sign((p1 - p3) | (p - p3));
    sum += sign((p2 - p1) | (p - p1));
@@ -386,6 +406,7 @@ Polygon grahamConvexHull(const std::vector<Point>& points)
    double cr_prod;
    int size = indices.size(), j;
    for (i = 0; i <= size; i++) {
+      GEOMETRY_COUNT(PREDICATE_EVALUATIONS, 1);
       cr_prod =
         (points[indices[Polygon::convCoord(i + 1, indices.size())]] -
          points[indices[Polygon::convCoord(i, indices.size())]]) |
@@ -492,14 +513,82 @@ Polygon jarvisConvexHull(std::vector<Point> points)
    return Polygon(convexHullPoints);
 }
 
+/**
+ * @brief Akl–Toussaint heuristic: drop points strictly inside the
+ * quadrilateral of extreme points by X and Y. Such points are not on
+ * the hull, remaining points keep their order.
+ */
+std::vector<Point> dropHullInterior(const std::vector<Point>& points)
+{
+   const size_t grain = 4096;
+   // Indices of points with min X, min Y, max X, max Y of each chunk
+   using extremes_t = std::array<size_t, 4>;
+   std::vector<extremes_t> parts(
+     impl::chunksCount(points.size(), grain));
+   auto update = [&](extremes_t& e, size_t i) {
+      const Point& p = points[i];
+      if (p[0] < points[e[0]][0])
+         e[0] = i;
+      if (p[1] < points[e[1]][1])
+         e[1] = i;
+      if (p[0] > points[e[2]][0])
+         e[2] = i;
+      if (p[1] > points[e[3]][1])
+         e[3] = i;
+   };
+   impl::parallelChunks(
+     points.size(),
+     grain,
+     [&](size_t chunk, size_t begin, size_t end) {
+        parts[chunk].fill(begin);
+        for (size_t i = begin + 1; i < end; ++i)
+           update(parts[chunk], i);
+     });
+   extremes_t e;
+   e.fill(0);
+   for (auto&& part : parts)
+      for (size_t i : part)
+         update(e, i);
+
+   // Vertices of the quadrilateral go counterclockwise
+   const Point quad[4] = {
+      points[e[0]], points[e[1]], points[e[2]], points[e[3]]
+   };
+   return impl::parallelCollect<Point>(
+     points.size(),
+     grain,
+     [&](size_t begin, size_t end, std::vector<Point>& part) {
+        GEOMETRY_COUNT(PREDICATE_EVALUATIONS, 4 * (end - begin));
+        for (size_t i = begin; i < end; ++i) {
+           bool is_inside = true;
+           for (size_t k = 0; k < 4 && is_inside; ++k) {
+              const Point& a = quad[k];
+              const Point& b = quad[(k + 1) % 4];
+              is_inside = ((b - a) | (points[i] - a)) > eps;
+           }
+           if (!is_inside)
+              part.push_back(points[i]);
+        }
+     });
+}
+
 Polygon Polygon::convexHull(const std::vector<Point>& points,
                             ConvexHullMethod m)
 {
+   GEOMETRY_TIMER("Polygon::convexHull");
+   // Filtering pays off only for large inputs; its result does not
+   // depend on threads count
+   const size_t filter_threshold = 8192;
+   std::vector<Point> filtered;
+   const bool is_filtered = points.size() >= filter_threshold;
+   if (is_filtered)
+      filtered = dropHullInterior(points);
+   const std::vector<Point>& input = is_filtered ? filtered : points;
    switch (m) {
       case ConvexHullMethod::GRAHAM:
-         return grahamConvexHull(points);
+         return grahamConvexHull(input);
       case ConvexHullMethod::JARVIS:
-         return jarvisConvexHull(points);
+         return jarvisConvexHull(input);
       default:
          break;
    }
@@ -509,6 +598,7 @@ Polygon Polygon::convexHull(const std::vector<Point>& points,
 std::unique_ptr<LineSegment> Polygon::segmentInsidePolygon(
   const LineSegment& s, ClipSegmentMethod m) const
 {
+   GEOMETRY_TIMER("Polygon::segmentInsidePolygon");
    switch (m) {
       case ClipSegmentMethod::COHEN_SUTHERLAND:
          return lineClippingCohenSutherland(s, *this);
@@ -536,6 +626,7 @@ std::unique_ptr<LineSegment> lineClippingCohenSutherland(
    Point lsBeginNext = lsBeginCurrent, lsEndNext = lsEndCurrent;
 
    while (pos != impl::SegmentPosition::INSIDE) {
+      GEOMETRY_COUNT(CLIPPING_ROUNDS, 1);
       if (pos == impl::SegmentPosition::OUTSIDE) {
          return std::unique_ptr<LineSegment>(nullptr);
       }
@@ -586,6 +677,7 @@ std::unique_ptr<LineSegment> lineClippingSprouleSutherland(
    impl::SegmentPosition current = impl::SegmentPosition::OUTSIDE,
                          next;
    for (size_t i = 0; i < n; ++i) {
+      GEOMETRY_COUNT(CLIPPING_ROUNDS, 1);
       auto pair = impl::getPartBeginEnd(type, i, offset, ls);
 
       next =
@@ -626,6 +718,7 @@ std::unique_ptr<LineSegment> lineClippingCyrusBeck(
    Point w_i, N_i;
    double Q_i, P_i, t0 = 0, t1 = 1, t;
    for (int i = 0; i != polygon.size() * direction; i += direction) {
+      GEOMETRY_COUNT(CLIPPING_ROUNDS, 1);
       N_i = Point(polygon[i + direction]["y"] - polygon[i]["y"],
                   polygon[i]["x"] - polygon[i + direction]["x"]);
       if (sign(N_i * (center - polygon[i])) == -1)
@@ -660,9 +753,60 @@ std::vector<Point> Polygon::get() const
    return _points;
 }
 
+PolygonProperties Polygon::properties(
+  PolygonProperties::Summation summation) const
+{
+   return PolygonProperties::compute(_points, summation);
+}
+
+Polygon Polygon::simplify(double tolerance,
+                          Simplification::Method m) const
+{
+   return Polygon(
+     Simplification::simplify(_points, tolerance, m, true));
+}
+
+RotatingCalipers::Summary Polygon::calipers() const
+{
+   std::vector<Vector2> hull(_points.size());
+   for (size_t i = 0; i < _points.size(); ++i)
+      hull[i] = Vector2::from(_points[i]);
+   RotatingCalipers::Summary result;
+   result.diameter = RotatingCalipers::diameter(hull.data(), hull.size());
+   result.width = RotatingCalipers::width(hull.data(), hull.size());
+   result.rectangle =
+     RotatingCalipers::minAreaRectangle(hull.data(), hull.size());
+   return result;
+}
+
+Polygon Polygon::transformed(const Transform& transform) const
+{
+   return Polygon(transform.apply(_points));
+}
+
+std::vector<uint> Polygon::triangulate(TriangulationMethod m) const
+{
+   GEOMETRY_TIMER("Polygon::triangulate");
+   std::vector<Vector2> vertices(_points.size());
+   for (size_t i = 0; i < _points.size(); ++i)
+      vertices[i] = Vector2::from(_points[i]);
+   switch (m) {
+      case TriangulationMethod::EAR_CLIPPING:
+         return Triangulation::earClipping(vertices.data(),
+                                           vertices.size());
+      case TriangulationMethod::MONOTONE_PARTITION:
+         return Triangulation::monotonePartition(vertices.data(),
+                                                 vertices.size());
+      default:
+         break;
+   }
+   return std::vector<uint>();
+}
+
 std::vector<Point> Polygon::pointsInsidePolygon(
   const std::vector<Point>& input, LocaliztionMethod m) const
 {
+   GEOMETRY_TIMER("Polygon::pointsInsidePolygon");
    switch (m) {
       case LocaliztionMethod::SIMPLE:
          return impl::pointsInsidePolygonSimple(*this, input);
@@ -715,8 +859,7 @@ namespace impl {
       if (angle > 180)
          angle = angle - 360;
       // check degree value, throw exception if invalid
-      angle = Angle(-90, angle, 90).degrees();
-      return angle;
+      return FastAngle::checkDegrees(angle, -90, 90);
    }
    std::vector<std::pair<Point, const size_t>> getPointBySide(
      const Side& s, const std::vector<Point>& points)
@@ -740,7 +883,7 @@ namespace impl {
    }
    LineType getFairLineType(const Line& l)
    {
-      Angle slope = atan(l.K()) * (180 / M_PI);
+      const double slope = atan(l.K()) * (180 / M_PI);
       if (60 < slope && slope < 90 || -90 < slope && slope < -60) {
          return LineType::CONST_X;
       } else if (-30 < slope && slope < 30) {
@@ -830,12 +973,11 @@ namespace impl {
    SegmentPosition getSegmentPosition(const PointCode& begin,
                                       const PointCode& end)
    {
-      if (begin.mask == end.mask) {
-         if (begin.mask == 0)
-            return SegmentPosition::INSIDE;
-         if ((begin.mask ^ end.mask) == 0)
-            return SegmentPosition::OUTSIDE;
-      }
+      if ((begin.mask | end.mask) == 0)
+         return SegmentPosition::INSIDE;
+      // Both endpoints are on the outer side of the same border
+      if ((begin.mask & end.mask) != 0)
+         return SegmentPosition::OUTSIDE;
       return SegmentPosition::UNKNOWN;
    }
    bool getPointOnBorder(Point& currentPoint,
@@ -899,24 +1041,23 @@ namespace impl {
    {
       throwOnNonSquare(polygon, "SIMPLE");
       auto minmax = xy_minmax(polygon);
-      size_t resultSize = 0;
-      const size_t size = input.size();
-      std::vector<Point> result(size);
-      for (size_t i = 0; i < size; ++i) {
-         if (PointCode(minmax, input[i]) == 0) {
-            result[resultSize] = input[i];
-            ++resultSize;
-         }
-      }
-      result.resize(resultSize);
-      return result;
+      // Chunks are merged in order, so input order is kept
+      return parallelCollect<Point>(
+        input.size(),
+        16384,
+        [&](size_t begin, size_t end, std::vector<Point>& part) {
+           GEOMETRY_COUNT(PREDICATE_EVALUATIONS, end - begin);
+           for (size_t i = begin; i < end; ++i)
+              if (PointCode(minmax, input[i]) == 0)
+                 part.push_back(input[i]);
+        });
    }
    std::vector<Point> pointsInsidePolygonGrid(
      const Polygon& polygon, const std::vector<Point>& input)
    {
       throwOnNonSquare(polygon, "GRID");
-      std::vector<Point> result;
-      std::stack<Point> result_stack;
+      if (input.empty())
+         return std::vector<Point>();
       /**
        * @brief Amount of a points per cell of matrix
        */
@@ -926,50 +1067,56 @@ namespace impl {
       const size_t rows_count =
         sqrt(input.size() / expected_density) + 1;
       const size_t cols_count = rows_count;
-      std::vector<std::vector<std::stack<Point>>> matrix =
+      const GridMatrix matrix =
         fillGridMatrix(input_area, rows_count, cols_count, input);
       GridMatrixIndices indices =
         mapInputAreaToGridMatrix(input_area, query_area, matrix);
-      for (size_t row = indices.j_min; row < indices.j_max; ++row) {
-         for (size_t col = indices.i_min; col < indices.i_max;
-              ++col) {
-            std::stack<Point>& stack = matrix[row][col];
-            if (row > indices.j_min && row < indices.j_max - 1 &&
-                col > indices.i_min && indices.i_max - 1) {
-               while (!stack.empty()) {
-                  result_stack.push(stack.top());
-                  stack.pop();
-               }
-            } else {
-               while (!stack.empty()) {
-                  Point current = stack.top();
-                  if (PointCode(query_area, current) == 0) {
-                     result_stack.push(current);
-                  }
-                  stack.pop();
-               }
-            }
-         }
-      }
-      result.resize(result_stack.size());
-      for (size_t i = 0; !result_stack.empty(); ++i) {
-         result[i] = result_stack.top();
-         result_stack.pop();
-      }
-
-      return result;
+      if (indices.j_min >= indices.j_max)
+         return std::vector<Point>();
+
+      // Rows of the query area in parallel, result is ordered by row,
+      // column and number of input point
+      return parallelCollect<Point>(
+        indices.j_max - indices.j_min,
+        1,
+        [&](size_t begin, size_t end, std::vector<Point>& part) {
+           for (size_t row = indices.j_min + begin;
+                row < indices.j_min + end;
+                ++row)
+              for (size_t col = indices.i_min; col < indices.i_max;
+                   ++col) {
+                 GEOMETRY_COUNT(GRID_CELLS_VISITED, 1);
+                 const size_t cell = row * cols_count + col;
+                 // Cells not on the border of the query area are
+                 // inside it entirely
+                 const bool is_inner =
+                   row > indices.j_min && row < indices.j_max - 1 &&
+                   col > indices.i_min && col < indices.i_max - 1;
+                 for (size_t k = matrix.offsets[cell];
+                      k < matrix.offsets[cell + 1];
+                      ++k) {
+                    const Point& current = input[matrix.items[k]];
+                    if (is_inner) {
+                       part.push_back(current);
+                       continue;
+                    }
+                    GEOMETRY_COUNT(PREDICATE_EVALUATIONS, 1);
+                    if (PointCode(query_area, current) == 0)
+                       part.push_back(current);
+                 }
+              }
+        });
    }
-
    GridMatrixIndices mapInputAreaToGridMatrix(
      const std::pair<std::pair<double, double>,
                      std::pair<double, double>>& input_xy_minmax,
      const std::pair<std::pair<double, double>,
                      std::pair<double, double>>& query_xy_minmax,
-     const std::vector<std::vector<std::stack<Point>>> gridMatrix)
+     const GridMatrix& gridMatrix)
    {
       GridMatrixIndices result;
-      const size_t rows_count = gridMatrix.size();
-      const size_t cols_count = gridMatrix.at(0).size();
+      const long rows_count = gridMatrix.rows_count;
+      const long cols_count = gridMatrix.cols_count;
 
       const double& input_x_min = input_xy_minmax.first.first;
       const double& input_x_max = input_xy_minmax.first.second;
@@ -985,25 +1132,31 @@ namespace impl {
         (input_x_max - input_x_min) / cols_count;
       const double cell_height =
         (input_y_max - input_y_min) / rows_count;
+      // Cell number of a coordinate, clamped to [0, count]
+      auto toCell = [](double offset, double size, long count) {
+         if (!(size > 0))
+            return (offset < 0) ? 0L : count;
+         const double cell = std::floor(offset / size);
+         return static_cast<long>(
+           std::max(0.0, std::min<double>(count, cell)));
+      };
 
-      const long i_min = static_cast<long>(
-                   (query_x_min - input_x_min) / cell_width),
-                 i_max = static_cast<long>(
-                           (query_x_max - input_x_min) / cell_width) +
-                         1,
-                 j_min = static_cast<long>(
-                   (query_y_min - input_y_min) / cell_height),
-                 j_max =
-                   static_cast<long>((query_y_max - input_y_min) /
-                                     cell_height) +
-                   1;
-      result.i_min = (i_min > cols_count) ? cols_count : i_min;
-      result.i_max = (i_max > cols_count) ? cols_count : i_max;
-      result.j_min = (j_min > rows_count) ? rows_count : j_min;
-      result.j_max = (j_max > rows_count) ? rows_count : j_max;
+      const long i_last = cols_count - 1, j_last = rows_count - 1;
+      result.i_min =
+        toCell(query_x_min - input_x_min, cell_width, i_last);
+      result.i_max =
+        toCell(query_x_max - input_x_min, cell_width, i_last) + 1;
+      result.j_min =
+        toCell(query_y_min - input_y_min, cell_height, j_last);
+      result.j_max =
+        toCell(query_y_max - input_y_min, cell_height, j_last) + 1;
+      // Query area does not overlap input area
+      if (query_x_max < input_x_min || query_x_min > input_x_max ||
+          query_y_max < input_y_min || query_y_min > input_y_max)
+         result.i_max = result.i_min, result.j_max = result.j_min;
       return result;
    }
-   std::vector<std::vector<std::stack<Point>>> fillGridMatrix(
+   GridMatrix fillGridMatrix(
      const std::pair<std::pair<double, double>,
                      std::pair<double, double>>& area_xy_minmax,
      const size_t rows_count, const size_t cols_count,
@@ -1013,37 +1166,40 @@ namespace impl {
       const double& x_max = area_xy_minmax.first.second;
       const double& y_min = area_xy_minmax.second.first;
       const double& y_max = area_xy_minmax.second.second;
-      std::vector<bool> isUsed(input.size(), false);
 
       const double cell_width = (x_max - x_min) / cols_count;
       const double cell_height = (y_max - y_min) / rows_count;
+      auto toCell = [](double offset, double size, size_t count) {
+         if (!(size > 0) || offset <= 0)
+            return size_t(0);
+         return std::min(count - 1,
+                         static_cast<size_t>(offset / size));
+      };
 
-      /**
-       * @brief Initialize matrix
-       */
-      std::vector<std::vector<std::stack<Point>>> matrix;
-      matrix.resize(rows_count);
-      for (size_t row = 0; row < rows_count; ++row) {
-         matrix[row].resize(cols_count);
-         for (size_t col = 0; col < cols_count; ++col) {
-            std::pair<double, double> cell_x_minmax = {
-               x_min + cell_width * col,
-               x_min + cell_width * (col + 1)
-            };
-            std::pair<double, double> cell_y_minmax = {
-               y_min + cell_height * row,
-               y_min + cell_height * (row + 1)
-            };
-            for (size_t i = 0; i < input.size(); ++i) {
-               if (PointCode({ cell_x_minmax, cell_y_minmax },
-                             input[i]) == 0 &&
-                   !isUsed[i]) {
-                  isUsed[i] = true;
-                  matrix[row][col].push(input[i]);
-               }
-            }
-         }
-      }
+      GridMatrix matrix { rows_count, cols_count, {}, {} };
+      // Cell of each point is computed in parallel, then points are
+      // placed by counting sort, which keeps input order in cells
+      std::vector<size_t> cells(input.size());
+      parallelFor(
+        0, input.size(), 16384, [&](size_t begin, size_t end) {
+           for (size_t i = begin; i < end; ++i) {
+              const Point& p = input[i];
+              cells[i] =
+                toCell(p["y"] - y_min, cell_height, rows_count) *
+                  cols_count +
+                toCell(p["x"] - x_min, cell_width, cols_count);
+           }
+        });
+      matrix.offsets.assign(rows_count * cols_count + 1, 0);
+      for (size_t cell : cells)
+         ++matrix.offsets[cell + 1];
+      for (size_t c = 0; c < rows_count * cols_count; ++c)
+         matrix.offsets[c + 1] += matrix.offsets[c];
+      matrix.items.resize(input.size());
+      std::vector<size_t> fill(matrix.offsets.begin(),
+                               matrix.offsets.end() - 1);
+      for (size_t i = 0; i < input.size(); ++i)
+         matrix.items[fill[cells[i]]++] = i;
       return matrix;
    }
    void throwOnNonSquare(const Polygon& polygon,
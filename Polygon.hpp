@@ -10,6 +10,10 @@
 
 #include "LineSegment.hpp"
 #include "Point.hpp"
+#include "PolygonProperties.hpp"
+#include "RotatingCalipers.hpp"
+#include "Simplification.hpp"
+#include "Transform.hpp"
 
 class Polygon
 {
@@ -51,6 +55,11 @@ class Polygon
       SPROULE_SUTHERLAND,
       CYRUS_BECK
    };
+   enum TriangulationMethod
+   {
+      EAR_CLIPPING,      // fast for small polygons
+      MONOTONE_PARTITION // O(n log n) for any polygon
+   };
 
    Polygon(const std::vector<Point>& points);
    Polygon(Point* points, size_t size);
@@ -79,6 +88,12 @@ class Polygon
     */
    std::unique_ptr<LineSegment> segmentInsidePolygon(
      const LineSegment& ls, ClipSegmentMethod m) const;
+   /**
+    * @brief Points of `input` inside `this` rectangular area,
+    * computed in parallel (see Parallel.hpp). SIMPLE keeps input
+    * order, GRID orders points by grid row, then column, then input
+    * order; both are the same for any threads count.
+    */
    std::vector<Point> pointsInsidePolygon(
      const std::vector<Point>& input, LocaliztionMethod m) const;
    /**
@@ -87,6 +102,40 @@ class Polygon
     * @return std::vector<Point> points of this polygon
     */
    std::vector<Point> get() const;
+   /**
+    * @brief Signed area, centroid, perimeter and orientation of
+    * `this` Polygon in one pass
+    */
+   PolygonProperties properties(
+     PolygonProperties::Summation summation =
+       PolygonProperties::FAST) const;
+   /**
+    * @brief Triangulate `this` simple Polygon
+    *
+    * @return std::vector<uint> index buffer over points of `this`
+    * Polygon, three indices per counterclockwise triangle (see
+    * Triangulation.hpp)
+    */
+   std::vector<uint> triangulate(TriangulationMethod m) const;
+   /**
+    * @brief Simplified copy of `this` Polygon, at least 3 points are
+    * kept
+    *
+    * @param tolerance distance for DOUGLAS_PEUCKER, area for
+    * VISVALINGAM_WHYATT (see Simplification.hpp)
+    */
+   Polygon simplify(double tolerance, Simplification::Method m) const;
+   /**
+    * @brief Diameter, width and minimal area bounding rectangle of
+    * `this` convex Polygon (for example, a convex hull) by rotating
+    * calipers, O(n)
+    */
+   RotatingCalipers::Summary calipers() const;
+   /**
+    * @brief Image of `this` Polygon under `transform` (see
+    * Transform.hpp), points are transformed in parallel
+    */
+   Polygon transformed(const Transform& transform) const;
 
    static Polygon makeByArea(
      const std::pair<double, double>& x_minmax,
@@ -94,6 +143,10 @@ class Polygon
    static int convCoord(int ind, int size);
    static bool isInsideTriangle(const Point& p1, const Point& p2,
                                 const Point& p3, const Point& p);
+   /**
+    * @brief Convex hull of `points`. Large inputs are first filtered
+    * in parallel by the Akl–Toussaint heuristic.
+    */
    static Polygon convexHull(const std::vector<Point>& points,
                              ConvexHullMethod m);
 };
@@ -0,0 +1,121 @@
+#include "PolygonProperties.hpp"
+#include "Instrumentation.hpp"
+#include "Parallel.hpp"
+#include "functions.hpp"
+
+namespace impl {
+   struct PlainSum
+   {
+      double sum = 0;
+
+      void add(double value) { sum += value; }
+      double value() const { return sum; }
+   };
+   /**
+    * @brief Neumaier summation: the rounding error of each addition
+    * is accumulated separately
+    */
+   struct NeumaierSum
+   {
+      double sum = 0, compensation = 0;
+
+      void add(double value)
+      {
+         const double t = sum + value;
+         if (std::abs(sum) >= std::abs(value))
+            compensation += (sum - t) + value;
+         else
+            compensation += (value - t) + sum;
+         sum = t;
+      }
+      double value() const { return sum + compensation; }
+   };
+
+   /**
+    * @brief The fused pass, `vertex(i)` returns Vector2 of vertex i
+    */
+   template<class Sum, class VertexFunction>
+   PolygonProperties polygonProperties(size_t count,
+                                       VertexFunction vertex)
+   {
+      PolygonProperties result;
+      if (count == 0)
+         return result;
+      // Coordinates relative to the first vertex: products of huge
+      // coordinates lose less precision
+      const Vector2 origin = vertex(0);
+      Sum area2, moment_x, moment_y, perimeter, edge_x, edge_y;
+      Vector2 current = { 0, 0 };
+      for (size_t i = 0; i < count; ++i) {
+         const Vector2 next =
+           (i + 1 < count) ? vertex(i + 1) - origin : Vector2 { 0, 0 };
+         const double cross = current | next;
+         area2.add(cross);
+         moment_x.add((current.x + next.x) * cross);
+         moment_y.add((current.y + next.y) * cross);
+         const Vector2 edge = next - current;
+         const double length = std::sqrt(edge * edge);
+         perimeter.add(length);
+         edge_x.add((current.x + next.x) * length);
+         edge_y.add((current.y + next.y) * length);
+         current = next;
+      }
+
+      result.signed_area = area2.value() / 2;
+      result.perimeter = perimeter.value();
+      result.orientation = static_cast<PolygonProperties::Orientation>(
+        sign(result.signed_area));
+      Vector2 centroid = { 0, 0 };
+      if (result.orientation != PolygonProperties::DEGENERATE)
+         centroid = Vector2 { moment_x.value(), moment_y.value() } *
+                    (1 / (3 * area2.value()));
+      else if (result.perimeter > 0)
+         centroid = Vector2 { edge_x.value(), edge_y.value() } *
+                    (1 / (2 * result.perimeter));
+      result.centroid = centroid + origin;
+      return result;
+   }
+
+   template<class VertexFunction>
+   PolygonProperties polygonProperties(
+     size_t count, VertexFunction vertex,
+     PolygonProperties::Summation summation)
+   {
+      if (summation == PolygonProperties::COMPENSATED)
+         return polygonProperties<NeumaierSum>(count, vertex);
+      return polygonProperties<PlainSum>(count, vertex);
+   }
+} // namespace impl
+
+PolygonProperties PolygonProperties::compute(const Vector2* vertices,
+                                             size_t count,
+                                             Summation summation)
+{
+   return impl::polygonProperties(
+     count, [=](size_t i) { return vertices[i]; }, summation);
+}
+
+PolygonProperties PolygonProperties::compute(
+  const std::vector<Point>& vertices, Summation summation)
+{
+   return impl::polygonProperties(
+     vertices.size(),
+     [&](size_t i) { return Vector2::from(vertices[i]); },
+     summation);
+}
+
+std::vector<PolygonProperties> PolygonProperties::computeBatch(
+  const std::vector<Vector2>& vertices,
+  const std::vector<size_t>& offsets, Summation summation)
+{
+   GEOMETRY_TIMER("PolygonProperties::computeBatch");
+   const size_t polygons = offsets.empty() ? 0 : offsets.size() - 1;
+   std::vector<PolygonProperties> result(polygons);
+   impl::parallelFor(0, polygons, 256, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i)
+         result[i] = compute(vertices.data() + offsets[i],
+                             offsets[i + 1] - offsets[i],
+                             summation);
+   });
+   return result;
+}
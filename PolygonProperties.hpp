@@ -0,0 +1,72 @@
+#ifndef GEOMETRY_LIB_POLYGONPROPERTIES_HPP
+#define GEOMETRY_LIB_POLYGONPROPERTIES_HPP
+
+#include <cmath>
+#include <vector>
+
+#include "Vector2.hpp"
+
+/**
+ * @brief Signed area, area centroid, perimeter and orientation of a
+ * closed polygon (the last vertex is connected to the first one).
+ * All of them are computed in one pass over vertices without heap
+ * allocations.
+ */
+struct PolygonProperties
+{
+   enum Orientation
+   {
+      CLOCKWISE = -1,
+      DEGENERATE = 0,
+      COUNTERCLOCKWISE = 1
+   };
+   enum Summation
+   {
+      /**
+       * @brief Plain floating point sums
+       */
+      FAST,
+      /**
+       * @brief Neumaier (improved Kahan) compensated sums, for huge
+       * coordinates or polygons with millions of vertices
+       */
+      COMPENSATED
+   };
+
+   /**
+    * @brief Area, positive for counterclockwise vertices
+    */
+   double signed_area = 0;
+   /**
+    * @brief Centroid of the area. For degenerate polygons (zero area)
+    * centroid of the boundary.
+    */
+   Vector2 centroid = { 0, 0 };
+   double perimeter = 0;
+   /**
+    * @brief Direction of vertices, DEGENERATE if the area is closer
+    * than eps to zero
+    */
+   Orientation orientation = DEGENERATE;
+
+   double area() const { return std::abs(signed_area); }
+
+   static PolygonProperties compute(const Vector2* vertices,
+                                    size_t count,
+                                    Summation summation = FAST);
+   static PolygonProperties compute(const std::vector<Point>& vertices,
+                                    Summation summation = FAST);
+   /**
+    * @brief Properties of many polygons, computed in parallel
+    *
+    * @param vertices vertices of all polygons one after another
+    * @param offsets polygon i is vertices[offsets[i]] ..
+    * vertices[offsets[i + 1] - 1]
+    * @return properties of each polygon in input order
+    */
+   static std::vector<PolygonProperties> computeBatch(
+     const std::vector<Vector2>& vertices,
+     const std::vector<size_t>& offsets, Summation summation = FAST);
+};
+
+#endif // GEOMETRY_LIB_POLYGONPROPERTIES_HPP
@@ -0,0 +1,251 @@
+#include "RotatingCalipers.hpp"
+#include "Instrumentation.hpp"
+#include "Parallel.hpp"
+#include "PolygonProperties.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace impl {
+   inline size_t nextVertex(size_t k, size_t count)
+   {
+      return (k + 1 == count) ? 0 : k + 1;
+   }
+
+   /**
+    * @brief 1 for counterclockwise, -1 for clockwise, 0 if all
+    * vertices are (almost) collinear
+    */
+   int hullOrientation(const Vector2* hull, size_t count)
+   {
+      double min_x = hull[0].x, max_x = min_x, min_y = hull[0].y,
+             max_y = min_y;
+      for (size_t k = 1; k < count; ++k) {
+         min_x = std::min(min_x, hull[k].x);
+         max_x = std::max(max_x, hull[k].x);
+         min_y = std::min(min_y, hull[k].y);
+         max_y = std::max(max_y, hull[k].y);
+      }
+      const double area =
+        PolygonProperties::compute(hull, count).signed_area;
+      // Relative to the bounding box, so scale of coordinates does
+      // not matter
+      const double size2 = (max_x - min_x) * (max_x - min_x) +
+                           (max_y - min_y) * (max_y - min_y);
+      if (!(std::abs(area) > eps * size2))
+         return 0;
+      return (area > 0) ? 1 : -1;
+   }
+
+   /**
+    * @brief Diameter of collinear points: the farthest point from any
+    * point is an end of the segment
+    */
+   RotatingCalipers::Diameter collinearDiameter(const Vector2* hull,
+                                                size_t count)
+   {
+      auto farthest = [&](size_t from) {
+         size_t result = from;
+         double max_length2 = 0;
+         for (size_t k = 0; k < count; ++k) {
+            const Vector2 d = hull[k] - hull[from];
+            if (d * d > max_length2) {
+               max_length2 = d * d;
+               result = k;
+            }
+         }
+         return result;
+      };
+      RotatingCalipers::Diameter result;
+      result.first = farthest(0);
+      result.second = farthest(result.first);
+      const Vector2 d = hull[result.second] - hull[result.first];
+      result.length = std::sqrt(d * d);
+      return result;
+   }
+
+   /**
+    * @brief Calls f(edge, u, normal, min_u, max_u, max_normal, top)
+    * for each non-degenerate edge: u is the unit direction of the
+    * edge, normal is the unit normal towards the polygon, min_u,
+    * max_u and max_normal are extreme projections of vertices
+    * relative to the edge begin, top is the vertex farthest from the
+    * edge. The three calipers only move forward.
+    */
+   template<class F>
+   void rotateCalipers(const Vector2* hull, size_t count,
+                       int orientation, F&& f)
+   {
+      size_t left = 0, right = 0, top = 0;
+      bool is_first = true;
+      for (size_t i = 0; i < count; ++i) {
+         const Vector2& origin = hull[i];
+         const Vector2 edge = hull[nextVertex(i, count)] - origin;
+         const double length = std::sqrt(edge * edge);
+         if (!(length > 0))
+            continue;
+         const Vector2 u = edge * (1 / length);
+         const Vector2 normal = Vector2 { -u.y, u.x } * orientation;
+         auto along = [&](size_t k) { return (hull[k] - origin) * u; };
+         auto across = [&](size_t k) {
+            return (hull[k] - origin) * normal;
+         };
+         if (is_first) {
+            for (size_t k = 0; k < count; ++k) {
+               if (along(k) < along(left))
+                  left = k;
+               if (along(k) > along(right))
+                  right = k;
+               if (across(k) > across(top))
+                  top = k;
+            }
+            is_first = false;
+         }
+         // Steps are limited for non-convex input
+         for (size_t steps = 0; steps < count &&
+                                along(nextVertex(right, count)) >=
+                                  along(right);
+              ++steps)
+            right = nextVertex(right, count);
+         for (size_t steps = 0; steps < count &&
+                                across(nextVertex(top, count)) >=
+                                  across(top);
+              ++steps)
+            top = nextVertex(top, count);
+         for (size_t steps = 0; steps < count &&
+                                along(nextVertex(left, count)) <=
+                                  along(left);
+              ++steps)
+            left = nextVertex(left, count);
+         GEOMETRY_COUNT(PREDICATE_EVALUATIONS, 3);
+         f(i, u, normal, along(left), along(right), across(top), top);
+      }
+   }
+} // namespace impl
+
+RotatingCalipers::Diameter RotatingCalipers::diameter(
+  const Vector2* hull, size_t count)
+{
+   if (count == 0)
+      throw std::invalid_argument("RotatingCalipers: empty polygon");
+   if (count < 3 || impl::hullOrientation(hull, count) == 0)
+      return impl::collinearDiameter(hull, count);
+
+   Diameter result;
+   double max_length2 = -1;
+   auto check = [&](size_t a, size_t b) {
+      const Vector2 d = hull[b] - hull[a];
+      if (d * d > max_length2) {
+         max_length2 = d * d;
+         result.first = a;
+         result.second = b;
+      }
+   };
+   // Doubled area of triangle (a, b, c)
+   auto area = [&](size_t a, size_t b, size_t c) {
+      return std::abs((hull[b] - hull[a]) | (hull[c] - hull[a]));
+   };
+   size_t j = 1;
+   for (size_t i = 0; i < count; ++i) {
+      const size_t i1 = impl::nextVertex(i, count);
+      if (hull[i] == hull[i1])
+         continue;
+      // The vertex farthest from edge (i, i1) is antipodal to both
+      // ends; vertices passed on the way are checked too
+      for (size_t steps = 0;
+           steps < count &&
+           area(i, i1, impl::nextVertex(j, count)) >= area(i, i1, j);
+           ++steps) {
+         check(i, j);
+         check(i1, j);
+         j = impl::nextVertex(j, count);
+      }
+      GEOMETRY_COUNT(PREDICATE_EVALUATIONS, 2);
+      check(i, j);
+      check(i1, j);
+   }
+   result.length = std::sqrt(max_length2);
+   return result;
+}
+
+RotatingCalipers::Width RotatingCalipers::width(const Vector2* hull,
+                                                size_t count)
+{
+   if (count == 0)
+      throw std::invalid_argument("RotatingCalipers: empty polygon");
+   Width result;
+   const int orientation = impl::hullOrientation(hull, count);
+   if (count < 3 || orientation == 0)
+      return result;
+   result.width = -1;
+   impl::rotateCalipers(
+     hull,
+     count,
+     orientation,
+     [&](size_t edge, const Vector2&, const Vector2&, double, double,
+         double height, size_t top) {
+        if (result.width < 0 || height < result.width) {
+           result.width = height;
+           result.edge = edge;
+           result.vertex = top;
+        }
+     });
+   return result;
+}
+
+RotatingCalipers::Rectangle RotatingCalipers::minAreaRectangle(
+  const Vector2* hull, size_t count)
+{
+   if (count == 0)
+      throw std::invalid_argument("RotatingCalipers: empty polygon");
+   Rectangle result;
+   const int orientation = impl::hullOrientation(hull, count);
+   if (count < 3 || orientation == 0) {
+      // Degenerate rectangle around the segment
+      const Diameter d = impl::collinearDiameter(hull, count);
+      result.corners[0] = result.corners[3] = hull[d.first];
+      result.corners[1] = result.corners[2] = hull[d.second];
+      result.edge = d.first;
+      return result;
+   }
+   result.area = -1;
+   impl::rotateCalipers(
+     hull,
+     count,
+     orientation,
+     [&](size_t edge, const Vector2& u, const Vector2& normal,
+         double min_u, double max_u, double height, size_t) {
+        const double area = (max_u - min_u) * height;
+        if (result.area >= 0 && area >= result.area)
+           return;
+        const Vector2& origin = hull[edge];
+        result.area = area;
+        result.edge = edge;
+        result.corners[0] = origin + u * min_u;
+        result.corners[1] = origin + u * max_u;
+        result.corners[2] = origin + u * max_u + normal * height;
+        result.corners[3] = origin + u * min_u + normal * height;
+        if (orientation < 0)
+           std::swap(result.corners[1], result.corners[3]);
+     });
+   return result;
+}
+
+std::vector<RotatingCalipers::Summary> RotatingCalipers::computeBatch(
+  const std::vector<Vector2>& vertices,
+  const std::vector<size_t>& offsets)
+{
+   GEOMETRY_TIMER("RotatingCalipers::computeBatch");
+   const size_t polygons = offsets.empty() ? 0 : offsets.size() - 1;
+   std::vector<Summary> result(polygons);
+   impl::parallelFor(0, polygons, 256, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+         const Vector2* hull = vertices.data() + offsets[i];
+         const size_t count = offsets[i + 1] - offsets[i];
+         result[i].diameter = diameter(hull, count);
+         result[i].width = width(hull, count);
+         result[i].rectangle = minAreaRectangle(hull, count);
+      }
+   });
+   return result;
+}
@@ -0,0 +1,69 @@
+#ifndef GEOMETRY_LIB_ROTATINGCALIPERS_HPP
+#define GEOMETRY_LIB_ROTATINGCALIPERS_HPP
+
+#include <vector>
+
+#include "Vector2.hpp"
+#include "functions.hpp"
+
+/**
+ * @brief Rotating calipers over a convex polygon (for example, the
+ * result of Polygon::convexHull). Vertices are taken in their order,
+ * clockwise or counterclockwise, collinear and repeated vertices are
+ * allowed. Each function is O(h) for h vertices.
+ */
+class RotatingCalipers
+{
+  public:
+   /**
+    * @brief The farthest pair of vertices
+    */
+   struct Diameter
+   {
+      uint first = 0, second = 0;
+      double length = 0;
+   };
+   /**
+    * @brief Minimal distance between two parallel supporting lines,
+    * one of them goes through the edge (edge, edge + 1)
+    */
+   struct Width
+   {
+      uint edge = 0, vertex = 0;
+      double width = 0;
+   };
+   /**
+    * @brief Bounding rectangle of minimal area, one of its sides lies
+    * on the edge (edge, edge + 1). Corners are counterclockwise.
+    */
+   struct Rectangle
+   {
+      Vector2 corners[4] = {};
+      double area = 0;
+      uint edge = 0;
+   };
+   struct Summary
+   {
+      Diameter diameter;
+      Width width;
+      Rectangle rectangle;
+   };
+
+   static Diameter diameter(const Vector2* hull, size_t count);
+   static Width width(const Vector2* hull, size_t count);
+   static Rectangle minAreaRectangle(const Vector2* hull, size_t count);
+   /**
+    * @brief Diameter, width and rectangle of many convex polygons,
+    * computed in parallel
+    *
+    * @param vertices vertices of all polygons one after another
+    * @param offsets polygon i is vertices[offsets[i]] ..
+    * vertices[offsets[i + 1] - 1]
+    * @return results for each polygon in input order
+    */
+   static std::vector<Summary> computeBatch(
+     const std::vector<Vector2>& vertices,
+     const std::vector<size_t>& offsets);
+};
+
+#endif // GEOMETRY_LIB_ROTATINGCALIPERS_HPP
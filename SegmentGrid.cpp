@@ -0,0 +1,163 @@
+#include "SegmentGrid.hpp"
+#include "Instrumentation.hpp"
+#include "Parallel.hpp"
+
+#include <cmath>
+#include <limits>
+
+SegmentGrid::SegmentGrid(std::vector<CompactSegment> segments,
+                         double cell_size) :
+  _segments(std::move(segments))
+{
+   build(cell_size);
+}
+
+SegmentGrid::SegmentGrid(const std::vector<LineSegment>& segments,
+                         double cell_size) :
+  SegmentGrid(LineSegment::compact(segments), cell_size)
+{
+}
+
+uint SegmentGrid::column(double x) const
+{
+   const double c = (x - _min_x) / _cell_size;
+   return c <= 0 ? 0 : std::min<double>(_cols - 1, c);
+}
+
+uint SegmentGrid::row(double y) const
+{
+   const double r = (y - _min_y) / _cell_size;
+   return r <= 0 ? 0 : std::min<double>(_rows - 1, r);
+}
+
+void SegmentGrid::build(double cell_size)
+{
+   const size_t n = _segments.size();
+   double max_x = 0, max_y = 0, extent = 0;
+   if (n > 0) {
+      _min_x = _min_y = std::numeric_limits<double>::max();
+      max_x = max_y = std::numeric_limits<double>::lowest();
+   }
+   for (auto&& s : _segments) {
+      _min_x = std::min(_min_x, s.min_x);
+      _min_y = std::min(_min_y, s.min_y);
+      max_x = std::max(max_x, s.max_x);
+      max_y = std::max(max_y, s.max_y);
+      extent += std::max(s.max_x - s.min_x, s.max_y - s.min_y);
+   }
+   const double width = max_x - _min_x, height = max_y - _min_y;
+   if (!(cell_size > 0) && n > 0) {
+      // A typical segment covers few cells; clustered data gets small
+      // cells too, cells count is limited below
+      cell_size = extent / n;
+      if (!(cell_size > 0))
+         cell_size = std::max(width, height) / n;
+   }
+   _cell_size = (cell_size > 0) ? cell_size : 1;
+   // Limit cells count by 4 cells per segment for tiny cell_size
+   const double max_side = 2 * std::sqrt(double(n)) + 1;
+   _cols = std::min(max_side, std::floor(width / _cell_size) + 1);
+   _rows = std::min(max_side, std::floor(height / _cell_size) + 1);
+   _cell_size =
+     std::max(_cell_size, std::max(width / _cols, height / _rows));
+
+   // Counting pass, then scatter
+   _offsets.assign(cellsCount() + 1, 0);
+   for (auto&& s : _segments)
+      for (uint r = row(s.min_y), r_end = row(s.max_y); r <= r_end; ++r)
+         for (uint c = column(s.min_x), c_end = column(s.max_x);
+              c <= c_end;
+              ++c)
+            ++_offsets[size_t(r) * _cols + c + 1];
+   for (size_t c = 0; c < cellsCount(); ++c)
+      _offsets[c + 1] += _offsets[c];
+   _items.resize(_offsets.back());
+   std::vector<size_t> fill(_offsets.begin(), _offsets.end() - 1);
+   for (uint i = 0; i < n; ++i) {
+      const CompactSegment& s = _segments[i];
+      for (uint r = row(s.min_y), r_end = row(s.max_y); r <= r_end; ++r)
+         for (uint c = column(s.min_x), c_end = column(s.max_x);
+              c <= c_end;
+              ++c)
+            _items[fill[size_t(r) * _cols + c]++] = i;
+   }
+}
+
+SegmentGrid::pair_list_t SegmentGrid::candidatePairs() const
+{
+   GEOMETRY_TIMER("SegmentGrid::candidatePairs");
+   using pair_t = pair_list_t::value_type;
+   return impl::parallelCollect<pair_t>(
+     cellsCount(), 256, [&](size_t begin, size_t end, pair_list_t& part) {
+        for (size_t cell = begin; cell < end; ++cell) {
+           GEOMETRY_COUNT(GRID_CELLS_VISITED, 1);
+           const uint cell_row = cell / _cols, cell_col = cell % _cols;
+           for (size_t a = _offsets[cell]; a < _offsets[cell + 1]; ++a)
+              for (size_t b = a + 1; b < _offsets[cell + 1]; ++b) {
+                 const CompactSegment &sa = _segments[_items[a]],
+                                      &sb = _segments[_items[b]];
+                 if (!sa.isBoxOverlap(sb))
+                    continue;
+                 // Report the pair only in the cell of the lower left
+                 // corner of the boxes overlap. Clamping keeps the
+                 // corner in both boxes when they overlap only within
+                 // eps.
+                 const double x = std::min(std::max(sa.min_x, sb.min_x),
+                                           std::min(sa.max_x, sb.max_x)),
+                              y = std::min(std::max(sa.min_y, sb.min_y),
+                                           std::min(sa.max_y, sb.max_y));
+                 if (row(y) != cell_row || column(x) != cell_col)
+                    continue;
+                 // Items of a cell are in increasing order
+                 part.emplace_back(_items[a], _items[b]);
+              }
+        }
+     });
+}
+
+SegmentGrid::pair_list_t SegmentGrid::narrowPhase(
+  const pair_list_t& candidates) const
+{
+   GEOMETRY_TIMER("SegmentGrid::narrowPhase");
+   using pair_t = pair_list_t::value_type;
+   return impl::parallelCollect<pair_t>(
+     candidates.size(),
+     4096,
+     [&](size_t begin, size_t end, pair_list_t& part) {
+        GEOMETRY_COUNT(PREDICATE_EVALUATIONS, end - begin);
+        for (size_t i = begin; i < end; ++i)
+           if (CompactSegment::isIntersection(
+                 _segments[candidates[i].first],
+                 _segments[candidates[i].second]))
+              part.push_back(candidates[i]);
+     });
+}
+
+SegmentGrid::pair_list_t SegmentGrid::intersectingPairs() const
+{
+   return narrowPhase(candidatePairs());
+}
+
+std::vector<uint> SegmentGrid::query(const CompactSegment& segment) const
+{
+   std::vector<uint> result;
+   if (_segments.empty())
+      return result;
+   for (uint r = row(segment.min_y), r_end = row(segment.max_y);
+        r <= r_end;
+        ++r)
+      for (uint c = column(segment.min_x), c_end = column(segment.max_x);
+           c <= c_end;
+           ++c) {
+         const size_t cell = size_t(r) * _cols + c;
+         GEOMETRY_COUNT(GRID_CELLS_VISITED, 1);
+         for (size_t i = _offsets[cell]; i < _offsets[cell + 1]; ++i)
+            if (CompactSegment::isIntersection(segment,
+                                               _segments[_items[i]]))
+               result.push_back(_items[i]);
+      }
+   std::sort(result.begin(), result.end());
+   result.erase(std::unique(result.begin(), result.end()),
+                result.end());
+   return result;
+}
@@ -0,0 +1,76 @@
+#ifndef GEOMETRY_LIB_SEGMENTGRID_HPP
+#define GEOMETRY_LIB_SEGMENTGRID_HPP
+
+#include <utility>
+#include <vector>
+
+#include "CompactSegment.hpp"
+#include "LineSegment.hpp"
+
+/**
+ * @brief Broad phase for all-pairs segment intersection: uniform grid
+ * over bounding boxes of segments.
+ *
+ * Cells are stored in CSR form: segments of the cell c are
+ * _items[_offsets[c]] .. _items[_offsets[c + 1] - 1]. A pair sharing
+ * several cells is reported only by the cell containing the lower left
+ * corner of the overlap of their boxes, so no deduplication pass is
+ * needed. Both phases run in parallel chunks, results do not depend on
+ * threads count.
+ */
+class SegmentGrid
+{
+  public:
+   using pair_list_t = std::vector<std::pair<uint, uint>>;
+
+  private:
+   std::vector<CompactSegment> _segments;
+   double _min_x = 0, _min_y = 0, _cell_size = 1;
+   uint _cols = 1, _rows = 1;
+   std::vector<size_t> _offsets;
+   std::vector<uint> _items;
+
+   uint column(double x) const;
+   uint row(double y) const;
+   void build(double cell_size);
+
+  public:
+   /**
+    * @param cell_size side of a grid cell, if not positive it is chosen
+    * by segment lengths and density
+    */
+   SegmentGrid(std::vector<CompactSegment> segments,
+               double cell_size = 0);
+   SegmentGrid(const std::vector<LineSegment>& segments,
+               double cell_size = 0);
+
+   size_t size() const { return _segments.size(); }
+   const CompactSegment& operator[](size_t index) const
+   {
+      return _segments[index];
+   }
+   size_t cellsCount() const { return size_t(_cols) * _rows; }
+   double cellSize() const { return _cell_size; }
+
+   /**
+    * @brief Pairs (i, j), i < j, of segments with overlapping bounding
+    * boxes, each pair once. Pairs are ordered by grid cell, the order
+    * does not depend on threads count.
+    */
+   pair_list_t candidatePairs() const;
+   /**
+    * @brief Pairs (i, j), i < j, of intersecting segments, in order of
+    * candidatePairs()
+    */
+   pair_list_t intersectingPairs() const;
+   /**
+    * @brief Keep only pairs of intersecting segments, order is kept
+    */
+   pair_list_t narrowPhase(const pair_list_t& candidates) const;
+   /**
+    * @brief Numbers of segments intersecting `segment`, sorted
+    */
+   std::vector<uint> query(const CompactSegment& segment) const;
+};
+
+#endif // GEOMETRY_LIB_SEGMENTGRID_HPP
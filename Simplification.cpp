@@ -0,0 +1,240 @@
+#include "Simplification.hpp"
+#include "Instrumentation.hpp"
+
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+namespace impl {
+   const double infinity = std::numeric_limits<double>::infinity();
+
+   double distanceToSegment(const Vector2& p, const Vector2& a,
+                            const Vector2& b)
+   {
+      const Vector2 ab = b - a;
+      const double length2 = ab * ab;
+      double t = (length2 > 0) ? ((p - a) * ab) / length2 : 0;
+      t = std::min(1.0, std::max(0.0, t));
+      const Vector2 d = p - (a + ab * t);
+      return std::sqrt(d * d);
+   }
+
+   /**
+    * @brief Iterative Douglas–Peucker over points[first .. last]
+    * (indices modulo count), importance of a vertex is limited by
+    * importance of the vertex which split its range
+    */
+   void douglasPeucker(const Vector2* points, size_t count,
+                       size_t first, size_t last,
+                       std::vector<double>& importance)
+   {
+      struct Range
+      {
+         size_t first, last;
+         double limit;
+      };
+      std::vector<Range> stack = { { first, last, infinity } };
+      while (!stack.empty()) {
+         const Range range = stack.back();
+         stack.pop_back();
+         if (range.last <= range.first + 1)
+            continue;
+         const Vector2 &a = points[range.first % count],
+                       &b = points[range.last % count];
+         size_t split = range.first + 1;
+         double max_distance = -1;
+         for (size_t i = range.first + 1; i < range.last; ++i) {
+            const double d = distanceToSegment(points[i % count], a, b);
+            if (d > max_distance) {
+               max_distance = d;
+               split = i;
+            }
+         }
+         const double value = std::min(max_distance, range.limit);
+         importance[split % count] = value;
+         stack.push_back({ range.first, split, value });
+         stack.push_back({ split, range.last, value });
+      }
+   }
+
+   std::vector<double> douglasPeucker(const Vector2* points,
+                                      size_t count, bool closed)
+   {
+      std::vector<double> importance(count, infinity);
+      if (!closed) {
+         douglasPeucker(points, count, 0, count - 1, importance);
+         return importance;
+      }
+      // A ring is split into two chains by the first vertex and the
+      // vertex farthest from it
+      size_t far = 0;
+      double max_distance = -1;
+      for (size_t i = 1; i < count; ++i) {
+         const Vector2 d = points[i] - points[0];
+         if (d * d > max_distance) {
+            max_distance = d * d;
+            far = i;
+         }
+      }
+      douglasPeucker(points, count, 0, far, importance);
+      douglasPeucker(points, count, far, count, importance);
+      // The third vertex keeps the ring from collapsing
+      size_t third = 0;
+      for (size_t i = 0; i < count; ++i)
+         if (importance[i] != infinity &&
+             (importance[third] == infinity ||
+              importance[i] > importance[third]))
+            third = i;
+      importance[third] = infinity;
+      return importance;
+   }
+
+   std::vector<double> visvalingamWhyatt(const Vector2* points,
+                                         size_t count, bool closed)
+   {
+      std::vector<double> importance(count, infinity);
+      std::vector<size_t> prev(count), next(count);
+      for (size_t i = 0; i < count; ++i) {
+         prev[i] = (i + count - 1) % count;
+         next[i] = (i + 1) % count;
+      }
+      auto area = [&](size_t i) {
+         const Vector2& a = points[prev[i]];
+         return std::abs((points[i] - a) | (points[next[i]] - a)) / 2;
+      };
+
+      struct Entry
+      {
+         double area;
+         size_t index;
+         uint version;
+
+         bool operator>(const Entry& other) const
+         {
+            return area > other.area ||
+                   (area == other.area && index > other.index);
+         }
+      };
+      // Entries with old versions are skipped instead of removed
+      std::vector<uint> versions(count, 0);
+      std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>
+        heap;
+      const size_t begin = closed ? 0 : 1,
+                   end = closed ? count : count - 1;
+      for (size_t i = begin; i < end; ++i)
+         heap.push({ area(i), i, 0 });
+
+      size_t remaining = count;
+      const size_t min_remaining = closed ? 3 : 2;
+      double last = 0;
+      while (!heap.empty() && remaining > min_remaining) {
+         const Entry entry = heap.top();
+         heap.pop();
+         if (entry.version != versions[entry.index])
+            continue;
+         const size_t i = entry.index;
+         // Effective area does not decrease, so a vertex is not less
+         // important than vertices eliminated before it
+         last = std::max(last, entry.area);
+         importance[i] = last;
+         ++versions[i];
+         --remaining;
+         next[prev[i]] = next[i];
+         prev[next[i]] = prev[i];
+         for (size_t neighbour : { prev[i], next[i] })
+            if (closed || (neighbour != 0 && neighbour != count - 1))
+               heap.push({ area(neighbour),
+                           neighbour,
+                           ++versions[neighbour] });
+      }
+      return importance;
+   }
+} // namespace impl
+
+std::vector<double> Simplification::importance(const Vector2* points,
+                                               size_t count, Method m,
+                                               bool closed)
+{
+   if (count <= (closed ? 3 : 2))
+      return std::vector<double>(count, impl::infinity);
+   switch (m) {
+      case Method::DOUGLAS_PEUCKER:
+         return impl::douglasPeucker(points, count, closed);
+      case Method::VISVALINGAM_WHYATT:
+         return impl::visvalingamWhyatt(points, count, closed);
+      default:
+         break;
+   }
+   throw std::invalid_argument("Simplification: unknown method");
+}
+
+std::vector<uint> Simplification::simplify(const Vector2* points,
+                                           size_t count,
+                                           double tolerance, Method m,
+                                           bool closed)
+{
+   GEOMETRY_TIMER("Simplification::simplify");
+   const std::vector<double> values =
+     importance(points, count, m, closed);
+   std::vector<uint> result;
+   for (size_t i = 0; i < count; ++i)
+      if (values[i] > tolerance)
+         result.push_back(i);
+   return result;
+}
+
+std::vector<Point> Simplification::simplify(
+  const std::vector<Point>& points, double tolerance, Method m,
+  bool closed)
+{
+   std::vector<Vector2> converted(points.size());
+   for (size_t i = 0; i < points.size(); ++i)
+      converted[i] = Vector2::from(points[i]);
+   std::vector<Point> result;
+   for (uint i : simplify(
+          converted.data(), converted.size(), tolerance, m, closed))
+      result.push_back(points[i]);
+   return result;
+}
+
+LodPyramid::LodPyramid(const std::vector<Vector2>& points,
+                       Simplification::Method m, double tolerance,
+                       size_t levels_count, double factor,
+                       bool closed) :
+  _tolerance(tolerance),
+  _factor(factor)
+{
+   if (!(tolerance > 0) || !(factor > 1) || levels_count == 0)
+      throw std::invalid_argument(
+        "LodPyramid: tolerance should be positive, factor greater "
+        "than 1 and at least one level");
+   GEOMETRY_TIMER("LodPyramid::LodPyramid");
+   const std::vector<double> values = Simplification::importance(
+     points.data(), points.size(), m, closed);
+   _levels.resize(levels_count);
+   for (size_t k = 0; k < levels_count; ++k) {
+      const double current = this->tolerance(k);
+      for (size_t i = 0; i < points.size(); ++i)
+         if (values[i] > current)
+            _levels[k].push_back(i);
+   }
+}
+
+double LodPyramid::tolerance(size_t k) const
+{
+   return _tolerance * std::pow(_factor, k);
+}
+
+size_t LodPyramid::levelFor(double tolerance) const
+{
+   if (!(tolerance >= _tolerance))
+      return 0;
+   size_t k = std::min<double>(
+     std::log(tolerance / _tolerance) / std::log(_factor),
+     _levels.size() - 1);
+   // Rounding of logarithms at exact powers of factor
+   if (k + 1 < _levels.size() && this->tolerance(k + 1) <= tolerance)
+      ++k;
+   return k;
+}
@@ -0,0 +1,95 @@
+#ifndef GEOMETRY_LIB_SIMPLIFICATION_HPP
+#define GEOMETRY_LIB_SIMPLIFICATION_HPP
+
+#include <vector>
+
+#include "Vector2.hpp"
+#include "functions.hpp"
+
+/**
+ * @brief Simplification of polylines and closed rings.
+ *
+ * Both methods first rank vertices by importance, then a simplified
+ * line is the vertices with importance above the tolerance, in their
+ * original order. Importance does not grow towards less important
+ * vertices, so results for larger tolerances are subsets of results
+ * for smaller ones (see LodPyramid).
+ */
+class Simplification
+{
+  public:
+   enum Method
+   {
+      /**
+       * @brief Douglas–Peucker: importance is the distance to the
+       * chord which the vertex split, tolerance is a distance
+       */
+      DOUGLAS_PEUCKER,
+      /**
+       * @brief Visvalingam–Whyatt: importance is the effective area
+       * of the triangle with the neighbours at the time the vertex
+       * is eliminated, tolerance is an area
+       */
+      VISVALINGAM_WHYATT
+   };
+
+   /**
+    * @brief Importance of each vertex. Ends of an open polyline and
+    * three vertices of a closed ring are infinitely important.
+    *
+    * @param closed the last point is connected to the first one
+    */
+   static std::vector<double> importance(const Vector2* points,
+                                         size_t count, Method m,
+                                         bool closed = false);
+   /**
+    * @brief Indices of vertices kept with `tolerance`, increasing
+    */
+   static std::vector<uint> simplify(const Vector2* points,
+                                     size_t count, double tolerance,
+                                     Method m, bool closed = false);
+   static std::vector<Point> simplify(const std::vector<Point>& points,
+                                      double tolerance, Method m,
+                                      bool closed = false);
+};
+
+/**
+ * @brief Simplifications of one line for a geometric sequence of
+ * tolerances: level k uses tolerance * factor^k. Importance is
+ * computed once, a level is picked in O(1).
+ */
+class LodPyramid
+{
+  private:
+   double _tolerance, _factor;
+   std::vector<std::vector<uint>> _levels;
+
+  public:
+   /**
+    * @param tolerance tolerance of the finest level (number 0)
+    * @param levels_count number of levels
+    * @param factor ratio of tolerances of adjacent levels, greater
+    * than 1
+    */
+   LodPyramid(const std::vector<Vector2>& points,
+              Simplification::Method m, double tolerance,
+              size_t levels_count, double factor = 2,
+              bool closed = false);
+
+   size_t levelsCount() const { return _levels.size(); }
+   /**
+    * @brief Indices of vertices of level k, increasing
+    */
+   const std::vector<uint>& level(size_t k) const
+   {
+      return _levels.at(k);
+   }
+   double tolerance(size_t k) const;
+   /**
+    * @brief The coarsest level with tolerance not greater than
+    * `tolerance` (level 0 for smaller ones)
+    */
+   size_t levelFor(double tolerance) const;
+};
+
+#endif // GEOMETRY_LIB_SIMPLIFICATION_HPP
@@ -0,0 +1,237 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace impl {
+   /**
+    * @brief Pool and index of the worker running on this thread
+    */
+   thread_local const ThreadPool* currentPool = nullptr;
+   thread_local size_t currentWorker = 0;
+
+   struct Settings
+   {
+      std::mutex mutex;
+      std::shared_ptr<ThreadPool> pool;
+      size_t threads = 0;
+      ThreadPool::executor_t executor;
+      size_t executorConcurrency = 0;
+
+      static Settings& instance()
+      {
+         // Never destroyed: pool threads may run during static
+         // destruction
+         static Settings* settings = new Settings;
+         return *settings;
+      }
+   };
+
+   /**
+    * @brief State of one ThreadPool::run call. Helpers hold it by
+    * shared_ptr: a helper may start after the call has returned, it
+    * finds no work and exits.
+    */
+   struct ParallelJob
+   {
+      const std::function<void(size_t)>* body;
+      size_t count;
+      std::atomic<size_t> next { 0 };
+      std::atomic<size_t> done { 0 };
+      std::atomic<bool> failed { false };
+      std::exception_ptr error;
+      std::mutex mutex;
+      std::condition_variable finished;
+
+      void work()
+      {
+         for (size_t i = next++; i < count; i = next++) {
+            // body is valid here: the caller waits for this task
+            try {
+               if (!failed)
+                  (*body)(i);
+            } catch (...) {
+               std::lock_guard<std::mutex> lock(mutex);
+               if (!error)
+                  error = std::current_exception();
+               failed = true;
+            }
+            if (++done == count) {
+               std::lock_guard<std::mutex> lock(mutex);
+               finished.notify_all();
+            }
+         }
+      }
+      void wait()
+      {
+         std::unique_lock<std::mutex> lock(mutex);
+         finished.wait(lock, [this] { return done == count; });
+      }
+   };
+} // namespace impl
+
+ThreadPool::ThreadPool(size_t threads)
+{
+   if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency()) - 1;
+   for (size_t i = 0; i < threads; ++i)
+      _queues.push_back(std::make_unique<Queue>());
+   for (size_t i = 0; i < threads; ++i)
+      _threads.emplace_back([this, i] { workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+   }
+   _wake.notify_all();
+   for (auto&& thread : _threads)
+      thread.join();
+}
+
+void ThreadPool::submit(task_t task)
+{
+   if (_queues.empty()) {
+      task();
+      return;
+   }
+   size_t index;
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+      index = (impl::currentPool == this)
+                ? impl::currentWorker
+                : _next_queue++ % _queues.size();
+      ++_pending;
+   }
+   {
+      std::lock_guard<std::mutex> lock(_queues[index]->mutex);
+      _queues[index]->tasks.push_back(std::move(task));
+   }
+   _wake.notify_one();
+}
+
+bool ThreadPool::tryPop(size_t index, task_t& task)
+{
+   // Own tasks from the back (most recent, cache-warm)
+   {
+      Queue& own = *_queues[index];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (!own.tasks.empty()) {
+         task = std::move(own.tasks.back());
+         own.tasks.pop_back();
+         return true;
+      }
+   }
+   // Steal the oldest task of another worker
+   for (size_t k = 1; k < _queues.size(); ++k) {
+      Queue& victim = *_queues[(index + k) % _queues.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+         task = std::move(victim.tasks.front());
+         victim.tasks.pop_front();
+         return true;
+      }
+   }
+   return false;
+}
+
+void ThreadPool::workerLoop(size_t index)
+{
+   impl::currentPool = this;
+   impl::currentWorker = index;
+   task_t task;
+   while (true) {
+      {
+         std::unique_lock<std::mutex> lock(_mutex);
+         _wake.wait(lock, [this] { return _stop || _pending > 0; });
+         if (_pending == 0)
+            return; // stopped and drained
+         --_pending;
+      }
+      // A task is reserved by _pending, it is in some deque
+      while (!tryPop(index, task))
+         std::this_thread::yield();
+      task();
+      task = nullptr;
+   }
+}
+
+void ThreadPool::run(size_t count,
+                     const std::function<void(size_t)>& body)
+{
+   if (count == 0)
+      return;
+   impl::Settings& settings = impl::Settings::instance();
+   std::shared_ptr<ThreadPool> pool;
+   executor_t executor;
+   size_t helpers;
+   {
+      std::lock_guard<std::mutex> lock(settings.mutex);
+      if (settings.executor) {
+         executor = settings.executor;
+         helpers = settings.executorConcurrency;
+      } else {
+         if (!settings.pool)
+            settings.pool = std::make_shared<ThreadPool>(
+              settings.threads == 0 ? 0 : settings.threads - 1);
+         pool = settings.pool;
+         helpers = pool->workersCount();
+      }
+   }
+   helpers = std::min(helpers, count - 1);
+   if (helpers == 0) {
+      for (size_t i = 0; i < count; ++i)
+         body(i);
+      return;
+   }
+
+   auto job = std::make_shared<impl::ParallelJob>();
+   job->body = &body;
+   job->count = count;
+   for (size_t h = 0; h < helpers; ++h) {
+      task_t helper = [job] { job->work(); };
+      if (executor)
+         executor(std::move(helper));
+      else
+         pool->submit(std::move(helper));
+   }
+   job->work();
+   job->wait();
+   if (job->error)
+      std::rethrow_exception(job->error);
+}
+
+void ThreadPool::setThreadsCount(size_t threads)
+{
+   impl::Settings& settings = impl::Settings::instance();
+   std::shared_ptr<ThreadPool> previous;
+   {
+      std::lock_guard<std::mutex> lock(settings.mutex);
+      settings.threads = threads;
+      previous = std::move(settings.pool);
+   }
+   // The previous pool is destroyed here, or by the last running
+   // algorithm which uses it
+}
+
+size_t ThreadPool::threadsCount()
+{
+   impl::Settings& settings = impl::Settings::instance();
+   std::lock_guard<std::mutex> lock(settings.mutex);
+   if (settings.executor)
+      return settings.executorConcurrency + 1;
+   if (settings.threads != 0)
+      return settings.threads;
+   return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void ThreadPool::setExecutor(executor_t executor, size_t concurrency)
+{
+   impl::Settings& settings = impl::Settings::instance();
+   std::lock_guard<std::mutex> lock(settings.mutex);
+   settings.executor = std::move(executor);
+   settings.executorConcurrency = concurrency;
+}
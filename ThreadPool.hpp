@@ -0,0 +1,95 @@
+#ifndef GEOMETRY_LIB_THREADPOOL_HPP
+#define GEOMETRY_LIB_THREADPOOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Work-stealing thread pool used by batch algorithms of the
+ * library.
+ *
+ * Every worker owns a task deque: it takes own tasks from the back and
+ * steals from the front of other deques when its deque is empty.
+ * Batch algorithms do not use the pool directly, they call
+ * impl::parallelFor (see Parallel.hpp), which runs on the global pool
+ * or on the external executor if one is set.
+ */
+class ThreadPool
+{
+  public:
+   using task_t = std::function<void()>;
+   /**
+    * @brief External executor: must run the passed task once, on any
+    * thread, at any time
+    */
+   using executor_t = std::function<void(task_t)>;
+
+  private:
+   struct Queue
+   {
+      std::mutex mutex;
+      std::deque<task_t> tasks;
+   };
+
+   std::vector<std::unique_ptr<Queue>> _queues;
+   std::vector<std::thread> _threads;
+   std::mutex _mutex;
+   std::condition_variable _wake;
+   size_t _pending = 0;
+   size_t _next_queue = 0;
+   bool _stop = false;
+
+   bool tryPop(size_t index, task_t& task);
+   void workerLoop(size_t index);
+
+  public:
+   /**
+    * @param threads number of worker threads, 0 means one thread less
+    * than hardware threads (the thread calling parallel algorithm
+    * works too)
+    */
+   explicit ThreadPool(size_t threads = 0);
+   ~ThreadPool();
+   ThreadPool(const ThreadPool&) = delete;
+   ThreadPool& operator=(const ThreadPool&) = delete;
+
+   size_t workersCount() const { return _threads.size(); }
+   /**
+    * @brief Queue the task. Tasks submitted by a worker of `this` pool
+    * go to the deque of the worker.
+    */
+   void submit(task_t task);
+
+   /**
+    * @brief Run body(0) .. body(count - 1) and wait for all of them.
+    * The calling thread takes part in the work, so nested calls do not
+    * deadlock. The first exception thrown by body is rethrown, tasks
+    * not started yet are skipped after it.
+    */
+   static void run(size_t count, const std::function<void(size_t)>& body);
+
+   /**
+    * @brief Set number of threads used by batch algorithms, including
+    * the calling thread. 1 means serial execution, 0 means hardware
+    * threads count. Running algorithms finish on the previous pool.
+    */
+   static void setThreadsCount(size_t threads);
+   static size_t threadsCount();
+   /**
+    * @brief Route batch algorithms to an external executor instead of
+    * the internal pool
+    *
+    * @param executor executor, empty function switches back to the
+    * internal pool
+    * @param concurrency number of tasks to hand to the executor per
+    * parallel call, plus the calling thread
+    */
+   static void setExecutor(executor_t executor, size_t concurrency);
+};
+
+#endif // GEOMETRY_LIB_THREADPOOL_HPP
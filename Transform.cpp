@@ -0,0 +1,168 @@
+#include "Transform.hpp"
+#include "Instrumentation.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace impl {
+   const size_t transform_grain = 16384;
+
+   /**
+    * @brief Affine kernel: no division, the loop is vectorized
+    */
+   void applyAffine(const double* m, const Vector2* points, size_t count,
+                    Vector2* result)
+   {
+      for (size_t i = 0; i < count; ++i) {
+         const double x = points[i].x, y = points[i].y;
+         result[i].x = m[0] * x + m[1] * y + m[2];
+         result[i].y = m[3] * x + m[4] * y + m[5];
+      }
+   }
+   void applyProjective(const double* m, const Vector2* points,
+                        size_t count, Vector2* result)
+   {
+      for (size_t i = 0; i < count; ++i) {
+         const double x = points[i].x, y = points[i].y;
+         const double inverse = 1 / (m[6] * x + m[7] * y + m[8]);
+         result[i].x = (m[0] * x + m[1] * y + m[2]) * inverse;
+         result[i].y = (m[3] * x + m[4] * y + m[5]) * inverse;
+      }
+   }
+}
+
+Transform Transform::affine(double a, double b, double c, double d,
+                            double e, double f)
+{
+   return projective({ a, b, c, d, e, f, 0, 0, 1 });
+}
+
+Transform Transform::projective(const double (&matrix)[9])
+{
+   Transform result;
+   for (size_t i = 0; i < 9; ++i) {
+      if (!std::isfinite(matrix[i]))
+         throw std::invalid_argument(
+           "Transform: matrix elements should be finite");
+      result._m[i] = matrix[i];
+   }
+   return result;
+}
+
+Transform Transform::translation(const Vector2& offset)
+{
+   return affine(1, 0, offset.x, 0, 1, offset.y);
+}
+
+Transform Transform::rotation(const FastAngle& angle,
+                              const Vector2& center)
+{
+   const double c = angle.cos(), s = angle.sin();
+   // Translation keeps `center` in place
+   return affine(c, -s, center.x - c * center.x + s * center.y,
+                 s, c, center.y - s * center.x - c * center.y);
+}
+
+Transform Transform::scaling(double sx, double sy, const Vector2& center)
+{
+   return affine(sx, 0, center.x * (1 - sx), 0, sy, center.y * (1 - sy));
+}
+
+Transform Transform::shear(double kx, double ky)
+{
+   return affine(1, kx, 0, ky, 1, 0);
+}
+
+Transform Transform::operator*(const Transform& other) const
+{
+   Transform result;
+   for (size_t row = 0; row < 3; ++row)
+      for (size_t column = 0; column < 3; ++column)
+         result._m[row * 3 + column] =
+           _m[row * 3] * other._m[column] +
+           _m[row * 3 + 1] * other._m[3 + column] +
+           _m[row * 3 + 2] * other._m[6 + column];
+   return result;
+}
+
+Transform Transform::inverse() const
+{
+   const double* m = _m;
+   // Adjugate divided by the determinant
+   const double cofactors[9] = {
+      m[4] * m[8] - m[5] * m[7], m[2] * m[7] - m[1] * m[8],
+      m[1] * m[5] - m[2] * m[4], m[5] * m[6] - m[3] * m[8],
+      m[0] * m[8] - m[2] * m[6], m[2] * m[3] - m[0] * m[5],
+      m[3] * m[7] - m[4] * m[6], m[1] * m[6] - m[0] * m[7],
+      m[0] * m[4] - m[1] * m[3]
+   };
+   const double determinant =
+     m[0] * cofactors[0] + m[1] * cofactors[3] + m[2] * cofactors[6];
+   double scale = 0;
+   for (double value : _m)
+      scale = std::max(scale, std::abs(value));
+   if (!(std::abs(determinant) > eps * scale * scale * scale))
+      throw std::runtime_error("Transform: matrix is singular");
+   Transform result;
+   for (size_t i = 0; i < 9; ++i)
+      result._m[i] = cofactors[i] / determinant;
+   if (isAffine()) {
+      // Exact last row, so the inverse stays affine
+      result._m[6] = result._m[7] = 0;
+      result._m[8] = 1;
+   }
+   return result;
+}
+
+bool Transform::operator==(const Transform& other) const
+{
+   for (size_t i = 0; i < 9; ++i)
+      if (_m[i] != other._m[i])
+         return false;
+   return true;
+}
+
+void Transform::apply(const Vector2* points, size_t count,
+                      Vector2* result) const
+{
+   GEOMETRY_TIMER("Transform::apply");
+   const bool is_affine = isAffine();
+   const size_t grain = impl::transform_grain;
+   impl::parallelFor(0, count, grain, [&](size_t begin, size_t end) {
+      if (is_affine)
+         impl::applyAffine(_m, points + begin, end - begin,
+                           result + begin);
+      else
+         impl::applyProjective(_m, points + begin, end - begin,
+                               result + begin);
+   });
+}
+
+std::vector<Point> Transform::apply(
+  const std::vector<Point>& points) const
+{
+   // Point allocations dominate here
+   std::vector<Point> result(points.size());
+   const size_t grain = impl::transform_grain / 16;
+   impl::parallelFor(0, points.size(), grain, [&](size_t begin,
+                                                  size_t end) {
+      for (size_t i = begin; i < end; ++i)
+         result[i] = apply(points[i]);
+   });
+   return result;
+}
+
+void Transform::apply(const CompactSegment* segments, size_t count,
+                      CompactSegment* result) const
+{
+   const size_t grain = impl::transform_grain / 2;
+   impl::parallelFor(0, count, grain, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+         const Vector2 a = apply(segments[i].begin),
+                       b = apply(segments[i].end());
+         result[i] = CompactSegment::make(a, b);
+      }
+   });
+}
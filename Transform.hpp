@@ -0,0 +1,119 @@
+#ifndef GEOMETRY_LIB_TRANSFORM_HPP
+#define GEOMETRY_LIB_TRANSFORM_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "CompactSegment.hpp"
+#include "FastAngle.hpp"
+#include "Point.hpp"
+#include "Vector2.hpp"
+
+/**
+ * @brief Projective transform of the plane as a 3x3 matrix acting on
+ * homogeneous coordinates (x, y, 1). Affine transforms (the last row
+ * is 0 0 1) are applied without the division.
+ *
+ * Composition multiplies matrices, so a chain of any length built by
+ * then() or operator* is applied in a single pass over the data.
+ */
+class Transform
+{
+  private:
+   /**
+    * @brief Row-major matrix
+    */
+   double _m[9] = { 1, 0, 0, 0, 1, 0, 0, 0, 1 };
+
+  public:
+   /**
+    * @brief Identity transform
+    */
+   Transform() = default;
+   /**
+    * @brief x' = a x + b y + c, y' = d x + e y + f
+    */
+   static Transform affine(double a, double b, double c, double d,
+                           double e, double f);
+   /**
+    * @brief Row-major matrix, points are divided by the third
+    * coordinate
+    */
+   static Transform projective(const double (&matrix)[9]);
+
+   static Transform translation(const Vector2& offset);
+   /**
+    * @brief Counterclockwise rotation around `center`
+    */
+   static Transform rotation(const FastAngle& angle,
+                             const Vector2& center = { 0, 0 });
+   static Transform scaling(double sx, double sy,
+                            const Vector2& center = { 0, 0 });
+   /**
+    * @brief x' = x + kx y, y' = y + ky x
+    */
+   static Transform shear(double kx, double ky);
+
+   /**
+    * @brief Transform applying `other` first and `this` second
+    */
+   Transform operator*(const Transform& other) const;
+   /**
+    * @brief Transform applying `this` first and `next` second
+    */
+   Transform then(const Transform& next) const { return next * *this; }
+   /**
+    * @brief Inverse transform, throws std::runtime_error if the matrix
+    * is singular
+    */
+   Transform inverse() const;
+
+   bool isAffine() const
+   {
+      return _m[6] == 0 && _m[7] == 0 && _m[8] == 1;
+   }
+   double operator()(size_t row, size_t column) const
+   {
+      return _m[row * 3 + column];
+   }
+   bool operator==(const Transform& other) const;
+   bool operator!=(const Transform& other) const
+   {
+      return !(*this == other);
+   }
+
+   /**
+    * @brief Image of p. Points mapped to infinity by a projective
+    * transform get infinite or NaN coordinates.
+    */
+   Vector2 apply(const Vector2& p) const
+   {
+      const double x = _m[0] * p.x + _m[1] * p.y + _m[2];
+      const double y = _m[3] * p.x + _m[4] * p.y + _m[5];
+      const double w = _m[6] * p.x + _m[7] * p.y + _m[8];
+      return { x / w, y / w };
+   }
+   Point apply(const Point& p) const
+   {
+      return apply(Vector2::from(p)).toPoint();
+   }
+
+   /**
+    * @brief Images of `count` points in parallel, `result` may be
+    * `points`
+    */
+   void apply(const Vector2* points, size_t count, Vector2* result) const;
+   void apply(std::vector<Vector2>& points) const
+   {
+      apply(points.data(), points.size(), points.data());
+   }
+   std::vector<Point> apply(const std::vector<Point>& points) const;
+   /**
+    * @brief Images of segments with recomputed bounding boxes, `result`
+    * may be `segments`
+    */
+   void apply(const CompactSegment* segments, size_t count,
+              CompactSegment* result) const;
+};
+
+#endif // GEOMETRY_LIB_TRANSFORM_HPP
@@ -0,0 +1,591 @@
+#include "Triangulation.hpp"
+#include "Instrumentation.hpp"
+#include "PolygonProperties.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+
+namespace impl {
+   /**
+    * @brief The third coordinate of (b - a) x (c - b), positive for a
+    * left turn at b
+    */
+   inline double turn(const Vector2& a, const Vector2& b,
+                      const Vector2& c)
+   {
+      return (b - a) | (c - b);
+   }
+
+   /**
+    * @brief Appends triangle abc to `out` in counterclockwise order
+    */
+   inline void emitTriangle(const Vector2* vertices, uint a, uint b,
+                            uint c, std::vector<uint>& out)
+   {
+      if (turn(vertices[a], vertices[b], vertices[c]) < 0)
+         std::swap(b, c);
+      out.push_back(a);
+      out.push_back(b);
+      out.push_back(c);
+   }
+
+   struct EarNode
+   {
+      uint index;
+      uint32_t z;
+      EarNode *prev, *next;
+      /**
+       * @brief Neighbours in z-order, nullptr at the ends
+       */
+      EarNode *prev_z, *next_z;
+   };
+
+   class EarClipper
+   {
+     private:
+      const Vector2* _vertices;
+      std::vector<EarNode> _nodes;
+      std::vector<uint>& _out;
+      bool _hashed = false;
+      double _min_x = 0, _min_y = 0, _scale = 0;
+
+      const Vector2& at(const EarNode* node) const
+      {
+         return _vertices[node->index];
+      }
+      /**
+       * @brief Interleaved bits of coordinates scaled to 15 bits
+       */
+      uint32_t zOrder(const Vector2& p) const
+      {
+         uint32_t x = (p.x - _min_x) * _scale,
+                  y = (p.y - _min_y) * _scale;
+         x = (x | (x << 8)) & 0x00FF00FF;
+         x = (x | (x << 4)) & 0x0F0F0F0F;
+         x = (x | (x << 2)) & 0x33333333;
+         x = (x | (x << 1)) & 0x55555555;
+         y = (y | (y << 8)) & 0x00FF00FF;
+         y = (y | (y << 4)) & 0x0F0F0F0F;
+         y = (y | (y << 2)) & 0x33333333;
+         y = (y | (y << 1)) & 0x55555555;
+         return x | (y << 1);
+      }
+      void remove(EarNode* node)
+      {
+         node->next->prev = node->prev;
+         node->prev->next = node->next;
+         if (node->prev_z)
+            node->prev_z->next_z = node->next_z;
+         if (node->next_z)
+            node->next_z->prev_z = node->prev_z;
+      }
+      /**
+       * @brief Checks if p blocks ear abc: p is inside abc (or on its
+       * border) and is not convex
+       */
+      bool isBlocking(const EarNode* p, const EarNode* ear) const
+      {
+         const Vector2 &a = at(ear->prev), &b = at(ear),
+                       &c = at(ear->next), &q = at(p);
+         if (q == a || q == b || q == c)
+            return false;
+         GEOMETRY_COUNT(PREDICATE_EVALUATIONS, 1);
+         return ((b - a) | (q - a)) >= 0 && ((c - b) | (q - b)) >= 0 &&
+                ((a - c) | (q - c)) >= 0 &&
+                turn(at(p->prev), q, at(p->next)) <= 0;
+      }
+      bool isEar(const EarNode* ear) const
+      {
+         if (turn(at(ear->prev), at(ear), at(ear->next)) <= 0)
+            return false;
+         if (!_hashed) {
+            for (const EarNode* p = ear->next->next; p != ear->prev;
+                 p = p->next)
+               if (isBlocking(p, ear))
+                  return false;
+            return true;
+         }
+         const Vector2 &a = at(ear->prev), &b = at(ear),
+                       &c = at(ear->next);
+         const uint32_t min_z = zOrder(
+                          { std::min({ a.x, b.x, c.x }),
+                            std::min({ a.y, b.y, c.y }) }),
+                        max_z = zOrder(
+                          { std::max({ a.x, b.x, c.x }),
+                            std::max({ a.y, b.y, c.y }) });
+         // Z-order of a point inside the box is between z-orders of
+         // the box corners
+         for (const EarNode* p = ear->prev_z; p && p->z >= min_z;
+              p = p->prev_z)
+            if (p != ear->prev && p != ear->next && isBlocking(p, ear))
+               return false;
+         for (const EarNode* p = ear->next_z; p && p->z <= max_z;
+              p = p->next_z)
+            if (p != ear->prev && p != ear->next && isBlocking(p, ear))
+               return false;
+         return true;
+      }
+      /**
+       * @brief Removes duplicate and collinear vertices
+       *
+       * @return a remaining node
+       */
+      EarNode* filter(EarNode* start)
+      {
+         EarNode *p = start, *end = start;
+         bool again;
+         do {
+            again = false;
+            if (p != p->next &&
+                (at(p) == at(p->next) ||
+                 std::abs(turn(at(p->prev), at(p), at(p->next))) <=
+                   eps)) {
+               remove(p);
+               p = end = p->prev;
+               if (p == p->next)
+                  break;
+               again = true;
+            } else
+               p = p->next;
+         } while (again || p != end);
+         return end;
+      }
+
+     public:
+      EarClipper(const Vector2* vertices, size_t count,
+                 std::vector<uint>& out) :
+        _vertices(vertices),
+        _nodes(count),
+        _out(out)
+      {
+         // Nodes are linked counterclockwise
+         const bool reversed =
+           PolygonProperties::compute(vertices, count).signed_area < 0;
+         for (size_t i = 0; i < count; ++i) {
+            EarNode& node = _nodes[i];
+            node.index = reversed ? count - 1 - i : i;
+            node.prev = &_nodes[(i + count - 1) % count];
+            node.next = &_nodes[(i + 1) % count];
+            node.prev_z = node.next_z = nullptr;
+         }
+         _hashed = count > Triangulation::hashThreshold;
+         if (!_hashed)
+            return;
+
+         double max_x = vertices[0].x, max_y = vertices[0].y;
+         _min_x = max_x, _min_y = max_y;
+         for (size_t i = 1; i < count; ++i) {
+            _min_x = std::min(_min_x, vertices[i].x);
+            _min_y = std::min(_min_y, vertices[i].y);
+            max_x = std::max(max_x, vertices[i].x);
+            max_y = std::max(max_y, vertices[i].y);
+         }
+         const double size = std::max(max_x - _min_x, max_y - _min_y);
+         _scale = (size > 0) ? 32767 / size : 0;
+         std::vector<EarNode*> sorted(count);
+         for (size_t i = 0; i < count; ++i) {
+            _nodes[i].z = zOrder(at(&_nodes[i]));
+            sorted[i] = &_nodes[i];
+         }
+         std::sort(sorted.begin(),
+                   sorted.end(),
+                   [](const EarNode* a, const EarNode* b) {
+                      return a->z < b->z;
+                   });
+         for (size_t i = 0; i < count; ++i) {
+            sorted[i]->prev_z = (i > 0) ? sorted[i - 1] : nullptr;
+            sorted[i]->next_z = (i + 1 < count) ? sorted[i + 1] : nullptr;
+         }
+      }
+
+      void run()
+      {
+         EarNode* ear = filter(&_nodes[0]);
+         EarNode* stop = ear;
+         // 0: ears only, 1: after removing degenerate vertices,
+         // 2: clip any convex vertex (polygon is not simple)
+         int pass = 0;
+         while (ear->prev != ear->next) {
+            EarNode *prev = ear->prev, *next = ear->next;
+            if (isEar(ear) ||
+                (pass == 2 && turn(at(prev), at(ear), at(next)) > 0)) {
+               emitTriangle(
+                 _vertices, prev->index, ear->index, next->index, _out);
+               remove(ear);
+               // Skipping the next vertex gives less thin triangles
+               ear = stop = next->next;
+               pass = 0;
+               continue;
+            }
+            ear = next;
+            if (ear != stop)
+               continue;
+            if (pass == 0)
+               ear = stop = filter(ear);
+            else if (pass == 2)
+               break;
+            ++pass;
+         }
+      }
+   };
+
+   class MonotonePartition
+   {
+     private:
+      enum VertexType
+      {
+         START,
+         END,
+         SPLIT,
+         MERGE,
+         REGULAR
+      };
+
+      const Vector2* _vertices;
+      /**
+       * @brief Vertex indices counterclockwise, without repeated
+       * vertices
+       */
+      std::vector<uint> _indices;
+      size_t _count;
+      std::vector<uint>& _out;
+      double _sweep_y = 0;
+      std::vector<std::pair<uint, uint>> _diagonals;
+
+      uint index(size_t k) const { return _indices[k]; }
+      const Vector2& at(size_t k) const { return _vertices[index(k)]; }
+      size_t next(size_t k) const { return (k + 1) % _count; }
+      size_t prev(size_t k) const { return (k + _count - 1) % _count; }
+      /**
+       * @brief Sweep order: from top to bottom, from left to right
+       */
+      bool isAbove(size_t a, size_t b) const
+      {
+         const Vector2 &p = at(a), &q = at(b);
+         if (p.y != q.y)
+            return p.y > q.y;
+         if (p.x != q.x)
+            return p.x < q.x;
+         return a < b;
+      }
+      /**
+       * @brief X of edge (k, k + 1) at height y, the edge goes down
+       */
+      double edgeX(size_t k, double y) const
+      {
+         const Vector2 &a = at(k), &b = at(next(k));
+         if (a.y == b.y)
+            return b.x;
+         const double t =
+           std::min(1.0, std::max(0.0, (y - a.y) / (b.y - a.y)));
+         return a.x + t * (b.x - a.x);
+      }
+
+      struct EdgeLess
+      {
+         using is_transparent = void;
+         const MonotonePartition* owner;
+
+         bool operator()(size_t a, size_t b) const
+         {
+            const double y = owner->_sweep_y;
+            const double xa = owner->edgeX(a, y),
+                         xb = owner->edgeX(b, y);
+            if (xa != xb)
+               return xa < xb;
+            // Edges with common upper point, compare below it
+            const double lower =
+              std::max(owner->at(owner->next(a)).y,
+                       owner->at(owner->next(b)).y);
+            const double la = owner->edgeX(a, lower),
+                         lb = owner->edgeX(b, lower);
+            return (la != lb) ? la < lb : a < b;
+         }
+         bool operator()(size_t edge, const Vector2& p) const
+         {
+            return owner->edgeX(edge, owner->_sweep_y) < p.x;
+         }
+         bool operator()(const Vector2& p, size_t edge) const
+         {
+            return p.x < owner->edgeX(edge, owner->_sweep_y);
+         }
+      };
+      using status_t = std::set<size_t, EdgeLess>;
+
+      VertexType type(size_t k) const
+      {
+         const size_t p = prev(k), n = next(k);
+         const bool is_convex = turn(at(p), at(k), at(n)) > 0;
+         if (isAbove(k, p) && isAbove(k, n))
+            return is_convex ? START : SPLIT;
+         if (isAbove(p, k) && isAbove(n, k))
+            return is_convex ? END : MERGE;
+         return REGULAR;
+      }
+
+      /**
+       * @brief Plane sweep adding diagonals, which split the polygon
+       * into y-monotone parts
+       */
+      void partition()
+      {
+         std::vector<size_t> order(_count);
+         std::vector<VertexType> types(_count);
+         for (size_t k = 0; k < _count; ++k) {
+            order[k] = k;
+            types[k] = type(k);
+         }
+         std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            return isAbove(a, b);
+         });
+
+         status_t status(EdgeLess { this });
+         std::vector<status_t::iterator> position(_count,
+                                                  status.end());
+         std::vector<size_t> helper(_count);
+         auto insert = [&](size_t edge, size_t k) {
+            position[edge] = status.insert(edge).first;
+            helper[edge] = k;
+         };
+         auto finish = [&](size_t edge, size_t k) {
+            if (types[helper[edge]] == MERGE)
+               _diagonals.emplace_back(k, helper[edge]);
+            status.erase(position[edge]);
+         };
+         auto leftEdge = [&](size_t k) {
+            auto it = status.upper_bound(at(k));
+            if (it == status.begin())
+               throw std::runtime_error(
+                 "Triangulation: polygon is not simple");
+            return *--it;
+         };
+         auto updateLeft = [&](size_t k, bool always_diagonal) {
+            const size_t edge = leftEdge(k);
+            if (always_diagonal || types[helper[edge]] == MERGE)
+               _diagonals.emplace_back(k, helper[edge]);
+            helper[edge] = k;
+         };
+
+         for (size_t k : order) {
+            _sweep_y = at(k).y;
+            switch (types[k]) {
+               case START:
+                  insert(k, k);
+                  break;
+               case END:
+                  finish(prev(k), k);
+                  break;
+               case SPLIT:
+                  updateLeft(k, true);
+                  insert(k, k);
+                  break;
+               case MERGE:
+                  finish(prev(k), k);
+                  updateLeft(k, false);
+                  break;
+               case REGULAR:
+                  // Left chain: the interior is to the right
+                  if (isAbove(prev(k), k)) {
+                     finish(prev(k), k);
+                     insert(k, k);
+                  } else
+                     updateLeft(k, false);
+                  break;
+            }
+         }
+      }
+
+      /**
+       * @brief Triangulation of a y-monotone counterclockwise polygon
+       */
+      void triangulateMonotone(const std::vector<size_t>& face)
+      {
+         const size_t m = face.size();
+         if (m < 3)
+            return;
+         size_t top = 0, bottom = 0;
+         for (size_t i = 1; i < m; ++i) {
+            if (isAbove(face[i], face[top]))
+               top = i;
+            if (isAbove(face[bottom], face[i]))
+               bottom = i;
+         }
+         // Counterclockwise from the top goes down the left chain
+         std::vector<std::pair<size_t, bool>> sorted;
+         sorted.reserve(m);
+         sorted.emplace_back(face[top], true);
+         size_t left = (top + 1) % m, right = (top + m - 1) % m;
+         while (sorted.size() < m) {
+            if (left != bottom &&
+                (right == bottom || isAbove(face[left], face[right]))) {
+               sorted.emplace_back(face[left], true);
+               left = (left + 1) % m;
+            } else if (right != bottom) {
+               sorted.emplace_back(face[right], false);
+               right = (right + m - 1) % m;
+            } else
+               sorted.emplace_back(face[bottom], false);
+         }
+
+         auto emit = [&](size_t a, size_t b, size_t c) {
+            emitTriangle(_vertices, index(a), index(b), index(c), _out);
+         };
+         std::vector<std::pair<size_t, bool>> stack = { sorted[0],
+                                                        sorted[1] };
+         for (size_t j = 2; j + 1 < m; ++j) {
+            const size_t u = sorted[j].first;
+            const bool is_left = sorted[j].second;
+            if (is_left != stack.back().second) {
+               for (size_t i = 0; i + 1 < stack.size(); ++i)
+                  emit(u, stack[i].first, stack[i + 1].first);
+               stack = { sorted[j - 1], sorted[j] };
+               continue;
+            }
+            auto last = stack.back();
+            stack.pop_back();
+            while (!stack.empty()) {
+               const size_t t = stack.back().first;
+               // Diagonal from u to t is inside if the chain turns
+               // towards the interior at `last`
+               const double cross =
+                 is_left ? turn(at(t), at(last.first), at(u))
+                         : turn(at(u), at(last.first), at(t));
+               if (cross <= 0)
+                  break;
+               emit(u, last.first, t);
+               last = stack.back();
+               stack.pop_back();
+            }
+            stack.push_back(last);
+            stack.push_back(sorted[j]);
+         }
+         const size_t u = sorted[m - 1].first;
+         for (size_t i = 0; i + 1 < stack.size(); ++i)
+            emit(u, stack[i].first, stack[i + 1].first);
+      }
+
+      /**
+       * @brief Walks faces of the polygon split by diagonals and
+       * triangulates each of them
+       */
+      void triangulateFaces()
+      {
+         // Neighbours of each vertex in CSR form, counterclockwise
+         std::vector<size_t> offsets(_count + 1, 2);
+         offsets[0] = 0;
+         for (auto&& d : _diagonals) {
+            ++offsets[d.first + 1];
+            ++offsets[d.second + 1];
+         }
+         for (size_t k = 0; k < _count; ++k)
+            offsets[k + 1] += offsets[k];
+         std::vector<size_t> neighbours(offsets.back());
+         std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+         for (size_t k = 0; k < _count; ++k) {
+            neighbours[fill[k]++] = next(k);
+            neighbours[fill[k]++] = prev(k);
+         }
+         for (auto&& d : _diagonals) {
+            neighbours[fill[d.first]++] = d.second;
+            neighbours[fill[d.second]++] = d.first;
+         }
+         for (size_t k = 0; k < _count; ++k) {
+            const Vector2& origin = at(k);
+            std::sort(neighbours.begin() + offsets[k],
+                      neighbours.begin() + offsets[k + 1],
+                      [&](size_t a, size_t b) {
+                         const Vector2 da = at(a) - origin,
+                                       db = at(b) - origin;
+                         return std::atan2(da.y, da.x) <
+                                std::atan2(db.y, db.x);
+                      });
+         }
+         auto slot = [&](size_t from, size_t to) {
+            for (size_t s = offsets[from]; s < offsets[from + 1]; ++s)
+               if (neighbours[s] == to)
+                  return s;
+            throw std::logic_error("Triangulation: broken face");
+         };
+
+         // Half-edge (k, neighbours[s]) is visited; edges going
+         // clockwise along the boundary are outside
+         std::vector<bool> visited(neighbours.size(), false);
+         for (size_t k = 0; k < _count; ++k)
+            visited[slot(k, prev(k))] = true;
+         std::vector<size_t> face;
+         for (size_t start = 0; start < _count; ++start)
+            for (size_t s = offsets[start]; s < offsets[start + 1];
+                 ++s) {
+               if (visited[s])
+                  continue;
+               face.clear();
+               size_t from = start, current = s;
+               while (!visited[current]) {
+                  visited[current] = true;
+                  face.push_back(from);
+                  const size_t to = neighbours[current];
+                  // Next edge is the first one clockwise from the
+                  // reverse of the current edge
+                  const size_t back = slot(to, from);
+                  current = (back == offsets[to]) ? offsets[to + 1] - 1
+                                                  : back - 1;
+                  from = to;
+               }
+               triangulateMonotone(face);
+            }
+      }
+
+     public:
+      MonotonePartition(const Vector2* vertices, size_t count,
+                        std::vector<uint>& out) :
+        _vertices(vertices),
+        _out(out)
+      {
+         const bool reversed =
+           PolygonProperties::compute(vertices, count).signed_area < 0;
+         _indices.reserve(count);
+         for (size_t i = 0; i < count; ++i) {
+            const uint k = reversed ? count - 1 - i : i;
+            if (_indices.empty() || vertices[k] != at(_indices.size() - 1))
+               _indices.push_back(k);
+         }
+         while (_indices.size() > 1 &&
+                vertices[_indices.back()] == vertices[_indices[0]])
+            _indices.pop_back();
+         _count = _indices.size();
+      }
+
+      void run()
+      {
+         if (_count < 3)
+            return;
+         partition();
+         triangulateFaces();
+      }
+   };
+} // namespace impl
+
+std::vector<uint> Triangulation::earClipping(const Vector2* vertices,
+                                             size_t count)
+{
+   std::vector<uint> result;
+   if (count < 3)
+      return result;
+   result.reserve(3 * (count - 2));
+   impl::EarClipper(vertices, count, result).run();
+   return result;
+}
+
+std::vector<uint> Triangulation::monotonePartition(
+  const Vector2* vertices, size_t count)
+{
+   std::vector<uint> result;
+   if (count < 3)
+      return result;
+   result.reserve(3 * (count - 2));
+   impl::MonotonePartition(vertices, count, result).run();
+   return result;
+}
@@ -0,0 +1,47 @@
+#ifndef GEOMETRY_LIB_TRIANGULATION_HPP
+#define GEOMETRY_LIB_TRIANGULATION_HPP
+
+#include <vector>
+
+#include "Vector2.hpp"
+#include "functions.hpp"
+
+/**
+ * @brief Triangulation of simple polygons into an index buffer:
+ * triangle k is vertices[result[3k]], vertices[result[3k + 1]],
+ * vertices[result[3k + 2]]. Triangles are counterclockwise for both
+ * orientations of the polygon. Vertices are neither copied nor
+ * reordered, only indices are stored.
+ */
+class Triangulation
+{
+  public:
+   /**
+    * @brief Polygons with more vertices are indexed by z-order curve
+    * in ear clipping
+    */
+   static const size_t hashThreshold = 80;
+
+   /**
+    * @brief Ear clipping, O(n^2) in the worst case. For polygons with
+    * more than hashThreshold vertices an ear is checked only against
+    * vertices with z-order codes inside the bounding box of the ear,
+    * which is close to linear for typical polygons. Duplicate and
+    * collinear vertices are skipped, so the result may have less than
+    * n - 2 triangles.
+    */
+   static std::vector<uint> earClipping(const Vector2* vertices,
+                                        size_t count);
+   /**
+    * @brief Partition into y-monotone polygons by plane sweep, then
+    * triangulation of each one by a stack of reflex vertices. O(n log
+    * n) for any shape, n - 2 triangles (repeated vertices are
+    * skipped).
+    *
+    * @throw std::runtime_error if the polygon is not simple
+    */
+   static std::vector<uint> monotonePartition(const Vector2* vertices,
+                                              size_t count);
+};
+
+#endif // GEOMETRY_LIB_TRIANGULATION_HPP
@@ -0,0 +1,53 @@
+#ifndef GEOMETRY_LIB_VECTOR2_HPP
+#define GEOMETRY_LIB_VECTOR2_HPP
+
+#include "Point.hpp"
+
+/**
+ * @brief Plain 2D vector (or point) without heap storage. Used by
+ * batch algorithms where Point allocation per element is too costly.
+ */
+struct Vector2
+{
+   double x, y;
+
+   Vector2 operator+(const Vector2& other) const
+   {
+      return { x + other.x, y + other.y };
+   }
+   Vector2 operator-(const Vector2& other) const
+   {
+      return { x - other.x, y - other.y };
+   }
+   Vector2 operator*(double multiplier) const
+   {
+      return { x * multiplier, y * multiplier };
+   }
+   /**
+    * @brief Dot product
+    */
+   double operator*(const Vector2& other) const
+   {
+      return x * other.x + y * other.y;
+   }
+   /**
+    * @brief The third coordinate of the cross product
+    */
+   double operator|(const Vector2& other) const
+   {
+      return x * other.y - y * other.x;
+   }
+   bool operator==(const Vector2& other) const
+   {
+      return x == other.x && y == other.y;
+   }
+   bool operator!=(const Vector2& other) const
+   {
+      return !(*this == other);
+   }
+
+   Point toPoint() const { return Point(x, y); }
+   static Vector2 from(const Point& p) { return { p[0], p[1] }; }
+};
+
+#endif // GEOMETRY_LIB_VECTOR2_HPP
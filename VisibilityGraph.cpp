@@ -0,0 +1,500 @@
+#include "VisibilityGraph.hpp"
+#include "Instrumentation.hpp"
+#include "functions.hpp"
+
+#include <cmath>
+#include <set>
+#include <stdexcept>
+
+namespace impl {
+   /**
+    * @brief Sign of cross product (b - a) x (c - a)
+    */
+   int orientationSign(double ax, double ay, double bx, double by,
+                       double cx, double cy)
+   {
+      return sign((bx - ax) * (cy - ay) - (by - ay) * (cx - ax));
+   }
+   /**
+    * @brief Checks if segments ab and cd cross each other at single
+    * point which is not an endpoint of any of them
+    */
+   bool isProperIntersection(double ax, double ay, double bx,
+                             double by, double cx, double cy,
+                             double dx, double dy)
+   {
+      const int o1 = orientationSign(ax, ay, bx, by, cx, cy),
+                o2 = orientationSign(ax, ay, bx, by, dx, dy),
+                o3 = orientationSign(cx, cy, dx, dy, ax, ay),
+                o4 = orientationSign(cx, cy, dx, dy, bx, by);
+      return o1 * o2 < 0 && o3 * o4 < 0;
+   }
+   /**
+    * @brief Checks if point p lies on segment ab, but is not its
+    * endpoint
+    */
+   bool isOnSegmentInterior(double ax, double ay, double bx, double by,
+                            double px, double py)
+   {
+      if (orientationSign(ax, ay, bx, by, px, py) != 0)
+         return false;
+      const double t = (px - ax) * (bx - ax) + (py - ay) * (by - ay),
+                   length2 = (bx - ax) * (bx - ax) +
+                             (by - ay) * (by - ay);
+      return t > 0 && t < length2 && !isZero(t) &&
+             !isZero(length2 - t);
+   }
+} // namespace impl
+
+/**
+ * @brief Order of obstacle edges by distance from the sweep center
+ * along the current sweep ray. Edges of obstacles do not cross, so
+ * the order of active edges does not change while the ray rotates.
+ */
+struct VisibilityGraph::SweepOrder
+{
+   struct Ray
+   {
+      double px, py;
+      /**
+       * @brief Direction of the ray
+       */
+      double rx, ry;
+   };
+   const VisibilityGraph* graph;
+   /**
+    * @brief Current sweep ray, shared by all copies of the order
+    */
+   const Ray* ray;
+
+   /**
+    * @brief Parameter t of the ray point p + t * r on the edge line
+    */
+   double distance(uint edge) const
+   {
+      const Vertex &a = graph->_vertices[edge],
+                   &b = graph->_vertices[a.next];
+      const double &px = ray->px, &py = ray->py, &rx = ray->rx,
+                   &ry = ray->ry;
+      const double sx = b.x - a.x, sy = b.y - a.y;
+      const double denominator = rx * sy - ry * sx;
+      if (isZero(denominator)) {
+         // Edge is parallel to the ray, use its nearest endpoint
+         const double r2 = rx * rx + ry * ry;
+         return std::min(((a.x - px) * rx + (a.y - py) * ry) / r2,
+                         ((b.x - px) * rx + (b.y - py) * ry) / r2);
+      }
+      return ((a.x - px) * sy - (a.y - py) * sx) / denominator;
+   }
+
+   bool operator()(uint first, uint second) const
+   {
+      if (first == second)
+         return false;
+      const double d1 = distance(first), d2 = distance(second);
+      if (std::fabs(d1 - d2) > 1e-9 * std::max(1.0, std::fabs(d1)))
+         return d1 < d2;
+
+      // Edges meet at the same point of the ray. The edge which makes
+      // lesser angle with direction to the sweep center is closer.
+      const uint ends1[2] { first, graph->_vertices[first].next },
+        ends2[2] { second, graph->_vertices[second].next };
+      for (uint i = 0; i < 2; ++i)
+         for (uint j = 0; j < 2; ++j)
+            if (ends1[i] == ends2[j]) {
+               const Vertex& q = graph->_vertices[ends1[i]];
+               const Vertex &o1 = graph->_vertices[ends1[1 - i]],
+                            &o2 = graph->_vertices[ends2[1 - j]];
+               auto angle = [&](const Vertex& o) {
+                  const double ax = ray->px - q.x, ay = ray->py - q.y,
+                               bx = o.x - q.x, by = o.y - q.y;
+                  return std::atan2(std::fabs(ax * by - ay * bx),
+                                    ax * bx + ay * by);
+               };
+               const double a1 = angle(o1), a2 = angle(o2);
+               if (a1 != a2)
+                  return a1 < a2;
+               return first < second;
+            }
+      return first < second;
+   }
+};
+
+VisibilityGraph::VisibilityGraph() {}
+
+VisibilityGraph::VisibilityGraph(const std::vector<Polygon>& obstacles)
+{
+   for (auto&& obstacle : obstacles)
+      addObstacle(obstacle);
+}
+
+bool VisibilityGraph::isIntoInterior(uint v, double x, double y) const
+{
+   const Vertex &o = _vertices[v], &a = _vertices[o.prev],
+                &b = _vertices[o.next];
+   const double ax = a.x - o.x, ay = a.y - o.y, bx = b.x - o.x,
+                by = b.y - o.y, dx = x - o.x, dy = y - o.y;
+   auto cross = [](double x1, double y1, double x2, double y2) {
+      return x1 * y2 - y1 * x2;
+   };
+   // Obstacle is counterclockwise, interior angle goes from b to a
+   if (cross(bx, by, ax, ay) >= 0)
+      return sign(cross(bx, by, dx, dy)) > 0 &&
+             sign(cross(dx, dy, ax, ay)) > 0;
+   return !(sign(cross(ax, ay, dx, dy)) >= 0 &&
+            sign(cross(dx, dy, bx, by)) >= 0);
+}
+
+bool VisibilityGraph::isBlockedBy(size_t obstacle, double ax,
+                                  double ay, uint a, double bx,
+                                  double by, uint b) const
+{
+   for (uint v : _obstacles[obstacle]) {
+      const Vertex &p = _vertices[v], &q = _vertices[p.next];
+      if (v != a && v != b && p.next != a && p.next != b &&
+          impl::isProperIntersection(
+            ax, ay, bx, by, p.x, p.y, q.x, q.y))
+         return true;
+      if (v != a && v != b &&
+          impl::isOnSegmentInterior(ax, ay, bx, by, p.x, p.y) &&
+          (isIntoInterior(v, ax, ay) || isIntoInterior(v, bx, by)))
+         return true;
+   }
+   return (a != npos && _vertices[a].obstacle == obstacle &&
+           isIntoInterior(a, bx, by)) ||
+          (b != npos && _vertices[b].obstacle == obstacle &&
+           isIntoInterior(b, ax, ay));
+}
+
+bool VisibilityGraph::isInsideObstacle(size_t obstacle, double x,
+                                       double y) const
+{
+   bool inside = false;
+   for (uint v : _obstacles[obstacle]) {
+      const Vertex &p = _vertices[v], &q = _vertices[p.next];
+      if ((p.y > y) != (q.y > y) &&
+          x < p.x + (y - p.y) * (q.x - p.x) / (q.y - p.y))
+         inside = !inside;
+   }
+   return inside;
+}
+
+std::vector<uint> VisibilityGraph::sweep(
+  double x, double y, uint self, std::vector<size_t>* blockers) const
+{
+   struct Candidate
+   {
+      uint vertex;
+      double angle, distance2;
+   };
+   std::vector<Candidate> candidates;
+   candidates.reserve(_vertices.size());
+   for (uint v = 0; v < _vertices.size(); ++v) {
+      if (!_alive[v] || v == self)
+         continue;
+      const double dx = _vertices[v].x - x, dy = _vertices[v].y - y;
+      double angle = std::atan2(dy, dx);
+      if (angle < 0)
+         angle += 2 * M_PI;
+      candidates.push_back({ v, angle, dx * dx + dy * dy });
+   }
+   std::sort(candidates.begin(),
+             candidates.end(),
+             [](const Candidate& a, const Candidate& b) {
+                return a.angle < b.angle ||
+                       (a.angle == b.angle &&
+                        a.distance2 < b.distance2);
+             });
+
+   auto isIncidentToSelf = [&](uint edge) {
+      return self != npos &&
+             (edge == self || _vertices[edge].next == self);
+   };
+
+   // Active edges, initially edges crossed by the ray y = const to
+   // the right of the center
+   SweepOrder::Ray ray { x, y, 1, 0 };
+   SweepOrder order { this, &ray };
+   std::set<uint, SweepOrder> active(order);
+   std::vector<std::set<uint, SweepOrder>::iterator> position(
+     _vertices.size(), active.end());
+   for (uint e = 0; e < _vertices.size(); ++e) {
+      if (!_alive[e] || isIncidentToSelf(e))
+         continue;
+      const Vertex &a = _vertices[e], &b = _vertices[a.next];
+      const bool crosses = std::min(a.y, b.y) < y &&
+                           std::max(a.y, b.y) >= y &&
+                           !(a.y == y && b.y == y);
+      if (crosses && order.distance(e) > 0)
+         position[e] = active.insert(e).first;
+   }
+
+   // Obstacle which hides the candidate, none if it is visible
+   const size_t none = std::numeric_limits<size_t>::max();
+   std::vector<uint> result;
+   if (blockers)
+      blockers->clear();
+   const Candidate* previous = nullptr;
+   size_t previous_blocker = none;
+   for (auto&& candidate : candidates) {
+      const uint w = candidate.vertex;
+      const Vertex& vertex = _vertices[w];
+      ray.rx = vertex.x - x, ray.ry = vertex.y - y;
+
+      size_t blocker = none;
+      if (self != npos && isIntoInterior(self, vertex.x, vertex.y))
+         blocker = _vertices[self].obstacle;
+      else if (isIntoInterior(w, x, y))
+         blocker = vertex.obstacle;
+      else if (previous &&
+               impl::isOnSegmentInterior(
+                 x, y, vertex.x, vertex.y,
+                 _vertices[previous->vertex].x,
+                 _vertices[previous->vertex].y)) {
+         // Previous vertex lies on the segment to the current one
+         const uint p = previous->vertex;
+         const Vertex& pv = _vertices[p];
+         if (previous_blocker != none)
+            blocker = previous_blocker;
+         else if (isIntoInterior(p, vertex.x, vertex.y))
+            blocker = pv.obstacle;
+         for (auto it = active.begin();
+              blocker == none && it != active.end(); ++it) {
+            const Vertex &a = _vertices[*it], &b = _vertices[a.next];
+            if (*it != p && a.next != p && *it != w && a.next != w &&
+                impl::isProperIntersection(
+                  pv.x, pv.y, vertex.x, vertex.y, a.x, a.y, b.x, b.y))
+               blocker = a.obstacle;
+         }
+      } else if (!active.empty()) {
+         const uint closest = *active.begin();
+         if (closest != w && _vertices[closest].next != w &&
+             order.distance(closest) < 1 - 1e-9)
+            blocker = _vertices[closest].obstacle;
+      }
+      if (blocker == none)
+         result.push_back(w);
+      else if (blockers && blocker != vertex.obstacle &&
+               (self == npos || blocker != _vertices[self].obstacle))
+         blockers->push_back(blocker);
+
+      // Edges behind the ray end here, edges ahead start here
+      const uint incident[2] { vertex.prev, w };
+      for (uint e : incident) {
+         if (isIncidentToSelf(e))
+            continue;
+         const uint other = (e == w) ? vertex.next : e;
+         const int side = impl::orientationSign(
+           x, y, vertex.x, vertex.y, _vertices[other].x,
+           _vertices[other].y);
+         if (side < 0 && position[e] != active.end()) {
+            active.erase(position[e]);
+            position[e] = active.end();
+         }
+      }
+      for (uint e : incident) {
+         if (isIncidentToSelf(e))
+            continue;
+         const uint other = (e == w) ? vertex.next : e;
+         const int side = impl::orientationSign(
+           x, y, vertex.x, vertex.y, _vertices[other].x,
+           _vertices[other].y);
+         if (side > 0 && position[e] == active.end())
+            position[e] = active.insert(e).first;
+      }
+
+      previous = &candidate;
+      previous_blocker = blocker;
+   }
+   if (blockers) {
+      std::sort(blockers->begin(), blockers->end());
+      blockers->erase(std::unique(blockers->begin(), blockers->end()),
+                      blockers->end());
+   }
+   return result;
+}
+
+void VisibilityGraph::connect(uint a, uint b)
+{
+   auto& row_a = _visible[a];
+   auto it = std::lower_bound(row_a.begin(), row_a.end(), b);
+   if (it != row_a.end() && *it == b)
+      return;
+   row_a.insert(it, b);
+   auto& row_b = _visible[b];
+   row_b.insert(std::lower_bound(row_b.begin(), row_b.end(), a), a);
+}
+
+size_t VisibilityGraph::addObstacle(const Polygon& obstacle)
+{
+   GEOMETRY_TIMER("VisibilityGraph::addObstacle");
+   std::vector<Point> points = obstacle.get();
+   const size_t n = points.size();
+   if (n < 3)
+      throw std::invalid_argument(
+        "VisibilityGraph: obstacle should have at least 3 points");
+
+   double area2 = 0;
+   for (size_t i = 0; i < n; ++i)
+      area2 += points[i]["x"] * points[(i + 1) % n]["y"] -
+               points[(i + 1) % n]["x"] * points[i]["y"];
+   if (area2 < 0)
+      std::reverse(points.begin(), points.end());
+
+   const size_t id = _obstacles.size();
+   const uint first = _vertices.size();
+   _obstacles.push_back(std::vector<uint>(n));
+   for (uint i = 0; i < n; ++i) {
+      const uint prev = first + (i + n - 1) % n,
+                 next = first + (i + 1) % n;
+      _vertices.push_back(
+        { points[i]["x"], points[i]["y"], prev, next, id });
+      _alive.push_back(true);
+      _visible.push_back(std::vector<uint>());
+      _blockers.push_back(std::vector<size_t>());
+      _obstacles[id][i] = first + i;
+   }
+
+   // Drop existing edges crossing the new obstacle
+   for (uint a = 0; a < first; ++a) {
+      if (!_alive[a])
+         continue;
+      auto& row = _visible[a];
+      for (size_t i = 0; i < row.size(); ++i) {
+         const uint b = row[i];
+         if (a > b)
+            continue;
+         const Vertex &va = _vertices[a], &vb = _vertices[b];
+         if (isBlockedBy(id, va.x, va.y, a, vb.x, vb.y, b)) {
+            auto& other = _visible[b];
+            other.erase(
+              std::lower_bound(other.begin(), other.end(), a));
+            row.erase(row.begin() + i);
+            --i;
+            if (_blockers[a].empty() || _blockers[a].back() != id)
+               _blockers[a].push_back(id);
+         }
+      }
+   }
+
+   for (uint v = first; v < _vertices.size(); ++v)
+      for (uint w : sweep(_vertices[v].x, _vertices[v].y, v,
+                          &_blockers[v]))
+         connect(v, w);
+
+   _isGraphValid = false;
+   return id;
+}
+
+void VisibilityGraph::removeObstacle(size_t id)
+{
+   GEOMETRY_TIMER("VisibilityGraph::removeObstacle");
+   if (id >= _obstacles.size() || _obstacles[id].empty())
+      throw std::invalid_argument(
+        "VisibilityGraph: obstacle " + std::to_string(id) +
+        " does not exist");
+
+   for (uint v : _obstacles[id]) {
+      _alive[v] = false;
+      for (uint w : _visible[v]) {
+         auto& other = _visible[w];
+         auto it = std::lower_bound(other.begin(), other.end(), v);
+         if (it != other.end() && *it == v)
+            other.erase(it);
+      }
+      _visible[v].clear();
+      _visible[v].shrink_to_fit();
+      _blockers[v].clear();
+      _blockers[v].shrink_to_fit();
+   }
+
+   // Only pairs blocked by the removed obstacle may become visible,
+   // and each of them has an endpoint which recorded it
+   for (uint a = 0; a < _vertices.size(); ++a)
+      if (_alive[a] && std::binary_search(_blockers[a].begin(),
+                                          _blockers[a].end(), id))
+         for (uint b : sweep(_vertices[a].x, _vertices[a].y, a,
+                             &_blockers[a]))
+            connect(a, b);
+   _obstacles[id].clear();
+   _isGraphValid = false;
+}
+
+size_t VisibilityGraph::obstaclesCount() const
+{
+   size_t result = 0;
+   for (auto&& obstacle : _obstacles)
+      if (!obstacle.empty())
+         ++result;
+   return result;
+}
+
+bool VisibilityGraph::isVisible(const Point& a, const Point& b) const
+{
+   for (size_t o = 0; o < _obstacles.size(); ++o)
+      if (!_obstacles[o].empty() &&
+          (isBlockedBy(o, a["x"], a["y"], npos, b["x"], b["y"], npos) ||
+           isInsideObstacle(o, a["x"], a["y"]) ||
+           isInsideObstacle(o, b["x"], b["y"])))
+         return false;
+   return true;
+}
+
+void VisibilityGraph::updateGraph() const
+{
+   if (_isGraphValid)
+      return;
+   _graphNumbers.assign(_vertices.size(), npos);
+   std::vector<Point> points;
+   for (uint v = 0; v < _vertices.size(); ++v)
+      if (_alive[v]) {
+         _graphNumbers[v] = points.size();
+         points.push_back(Point(_vertices[v].x, _vertices[v].y));
+      }
+   edge_list_t edges;
+   for (uint v = 0; v < _vertices.size(); ++v)
+      for (uint w : _visible[v])
+         if (v < w)
+            edges.push_back({ _graphNumbers[v], _graphNumbers[w] });
+   _graph = std::make_unique<Graph>(edges, points);
+   _isGraphValid = true;
+}
+
+const Graph& VisibilityGraph::graph() const
+{
+   updateGraph();
+   return *_graph;
+}
+
+std::vector<Point> VisibilityGraph::shortestPath(const Point& from,
+                                                 const Point& to) const
+{
+   GEOMETRY_TIMER("VisibilityGraph::shortestPath");
+   for (size_t o = 0; o < _obstacles.size(); ++o)
+      if (!_obstacles[o].empty() &&
+          (isInsideObstacle(o, from["x"], from["y"]) ||
+           isInsideObstacle(o, to["x"], to["y"])))
+         return std::vector<Point>();
+   if (isVisible(from, to))
+      return std::vector<Point> { from, to };
+
+   updateGraph();
+   auto visibleFrom = [&](const Point& p) {
+      std::vector<uint> result = sweep(p["x"], p["y"], npos);
+      for (uint& v : result)
+         v = _graphNumbers[v];
+      return result;
+   };
+   Graph::PathSearch search(*_graph);
+   const Graph::Path path =
+     search.find(from, visibleFrom(from), to, visibleFrom(to));
+   if (path.vertices.empty())
+      return std::vector<Point>();
+   std::vector<Point> result;
+   result.reserve(path.vertices.size() + 2);
+   result.push_back(from);
+   for (uint v : path.vertices)
+      result.push_back(_graph->point(v));
+   result.push_back(to);
+   return result;
+}
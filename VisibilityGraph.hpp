@@ -0,0 +1,137 @@
+#ifndef GEOMETRY_LIB_VISIBILITYGRAPH_HPP
+#define GEOMETRY_LIB_VISIBILITYGRAPH_HPP
+
+#include <memory>
+#include <vector>
+
+#include "Graph.hpp"
+#include "Point.hpp"
+#include "Polygon.hpp"
+
+/**
+ * @brief Visibility graph of polygonal obstacles: vertices are vertices
+ * of obstacles, edges connect vertices which see each other (segment
+ * between them does not pass through interior of any obstacle).
+ *
+ * Visibility from a vertex is computed by rotational sweep (Lee's
+ * algorithm), O(n log n) per vertex, O(n^2 log n) for whole graph.
+ * Obstacles may be added or removed one by one, the graph is updated
+ * incrementally.
+ */
+class VisibilityGraph
+{
+  private:
+   struct Vertex
+   {
+      double x, y;
+      /**
+       * @brief Neighbour vertices in the obstacle, obstacle vertices
+       * are stored counterclockwise. Edge number `i` of obstacles is
+       * the edge from vertex `i` to vertex `next`.
+       */
+      uint prev, next;
+      size_t obstacle;
+   };
+   struct SweepOrder;
+
+   std::vector<Vertex> _vertices;
+   std::vector<bool> _alive;
+   /**
+    * @brief Vertex numbers of each obstacle, empty for removed ones
+    */
+   std::vector<std::vector<uint>> _obstacles;
+   /**
+    * @brief Sorted numbers of visible vertices for each vertex
+    */
+   std::vector<std::vector<uint>> _visible;
+   /**
+    * @brief Sorted obstacles which hide some vertex from each vertex,
+    * except obstacles of the two vertices. Every pair of invisible
+    * vertices is blocked by an obstacle of one of them or by one
+    * recorded for one of them, so removing an obstacle needs sweeps
+    * only from vertices which recorded it.
+    */
+   std::vector<std::vector<size_t>> _blockers;
+
+   mutable bool _isGraphValid = false;
+   mutable std::unique_ptr<Graph> _graph;
+   /**
+    * @brief Number in the cached graph of each vertex, npos for
+    * removed ones
+    */
+   mutable std::vector<uint> _graphNumbers;
+
+   static constexpr uint npos = static_cast<uint>(-1);
+
+   /**
+    * @brief Rotational sweep around (x, y)
+    *
+    * @param self number of vertex placed at (x, y), or npos for a
+    * free point
+    * @param blockers if not null, receives sorted obstacles which hide
+    * vertices, see _blockers
+    * @return numbers of all visible vertices
+    */
+   std::vector<uint> sweep(double x, double y, uint self,
+                           std::vector<size_t>* blockers = nullptr) const;
+   /**
+    * @brief Checks if direction from vertex `v` to (x, y) goes into
+    * interior of the obstacle of `v`
+    */
+   bool isIntoInterior(uint v, double x, double y) const;
+   /**
+    * @brief Checks if segment intersects interior of the obstacle
+    *
+    * @param a,b numbers of segment endpoint vertices, or npos for free
+    * points
+    */
+   bool isBlockedBy(size_t obstacle, double ax, double ay, uint a,
+                    double bx, double by, uint b) const;
+   bool isInsideObstacle(size_t obstacle, double x, double y) const;
+   void connect(uint a, uint b);
+   void updateGraph() const;
+
+  public:
+   VisibilityGraph();
+   VisibilityGraph(const std::vector<Polygon>& obstacles);
+
+   /**
+    * @brief Add obstacle and update the graph: sweeps from new
+    * vertices and drops existing edges blocked by the obstacle
+    *
+    * @param obstacle simple polygon, at least 3 points
+    * @return size_t obstacle identifier
+    */
+   size_t addObstacle(const Polygon& obstacle);
+   /**
+    * @brief Remove obstacle and update the graph: drops its vertices
+    * and sweeps again only from vertices it hid something from
+    *
+    * @param id identifier returned by addObstacle
+    */
+   void removeObstacle(size_t id);
+   size_t obstaclesCount() const;
+
+   /**
+    * @brief Checks if the segment ab does not pass through interior of
+    * any obstacle
+    */
+   bool isVisible(const Point& a, const Point& b) const;
+   /**
+    * @brief Get cached visibility graph. Vertex numbers are
+    * consecutive numbers of vertices of present obstacles.
+    */
+   const Graph& graph() const;
+   /**
+    * @brief Find shortest collision-free path. Only visibility from
+    * `from` and `to` is computed per query; A* runs on the cached graph
+    * with them attached as virtual vertices.
+    *
+    * @return Points of the path from `from` to `to`, empty if there
+    * is no path (a.e. `from` or `to` is inside an obstacle)
+    */
+   std::vector<Point> shortestPath(const Point& from,
+                                   const Point& to) const;
+};
+
+#endif // GEOMETRY_LIB_VISIBILITYGRAPH_HPP
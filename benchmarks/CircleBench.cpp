@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+
+#include "CircleIntersection.hpp"
+#include "CircleSet.hpp"
+#include "DataGenerator.hpp"
+#include "FastAngle.hpp"
+
+namespace {
+/**
+ * @brief `count` circles in the square [-1, 1] x [-1, 1], radii are
+ * scaled so a point hits about the same number of circles for any
+ * count; 4096 query points
+ */
+CircleSet makeCircleSet(size_t count, std::vector<Vector2>& points)
+{
+   bench::Generator generator;
+   std::vector<Vector2> centers;
+   std::vector<double> radii;
+   const double scale = 1 / std::sqrt(double(count));
+   for (auto&& p : generator.points(count, bench::UNIFORM)) {
+      centers.push_back(Vector2::from(p));
+      radii.push_back(scale * (0.5 + 0.25 * (centers.size() % 7)));
+   }
+   points.clear();
+   for (auto&& p : generator.points(4096, bench::UNIFORM))
+      points.push_back(Vector2::from(p));
+   return CircleSet(centers, radii);
+}
+
+void CircleSetLocateAll(benchmark::State& state)
+{
+   std::vector<Vector2> points;
+   const CircleSet set = makeCircleSet(state.range(0), points);
+   std::vector<CircleSet::Location> locations(set.size());
+   for (auto _ : state)
+      for (auto&& p : points) {
+         set.locateAll(p, locations.data());
+         benchmark::DoNotOptimize(locations.data());
+      }
+   state.SetItemsProcessed(state.iterations() * points.size() *
+                           set.size());
+}
+BENCHMARK(CircleSetLocateAll)->RangeMultiplier(8)->Range(64, 4096);
+
+void CircleSetHits(benchmark::State& state)
+{
+   std::vector<Vector2> points;
+   const CircleSet set = makeCircleSet(state.range(0), points);
+   size_t hits = 0;
+   for (auto _ : state)
+      hits = set.hits(points).size();
+   state.counters["hits"] = hits;
+   state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(CircleSetHits)->RangeMultiplier(8)->Range(64, 262144);
+
+void CircleSegmentBatch(benchmark::State& state)
+{
+   std::vector<Vector2> points;
+   const CircleSet set = makeCircleSet(state.range(0), points);
+   bench::Generator generator;
+   const std::vector<CompactSegment> segments = LineSegment::compact(
+     generator.segments(state.range(0),
+                        bench::UNIFORM,
+                        2 / std::sqrt(double(state.range(0)))));
+   size_t hits = 0;
+   for (auto _ : state)
+      hits = CircleIntersection::intersectBatch(segments, set).size();
+   state.counters["hits"] = hits;
+   state.SetItemsProcessed(state.iterations() * segments.size());
+}
+BENCHMARK(CircleSegmentBatch)->RangeMultiplier(8)->Range(64, 262144);
+
+void ArcTessellate(benchmark::State& state)
+{
+   // 1024 arcs of the unit circle, tolerance 10^-range(0)
+   std::vector<CompactArc> arcs;
+   for (size_t i = 0; i < 1024; ++i)
+      arcs.push_back(CompactArc::make({ 0, 0 }, 1, i * 0.01, 1 + i % 5));
+   const double tolerance = std::pow(10.0, -state.range(0));
+   std::vector<Vector2> points;
+   for (auto _ : state) {
+      points.clear();
+      for (auto&& arc : arcs)
+         arc.tessellate(tolerance, points);
+      benchmark::DoNotOptimize(points.data());
+   }
+   state.counters["points"] = points.size();
+   state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(ArcTessellate)->DenseRange(2, 6, 2);
+
+/**
+ * @brief Rotating a point by a sum of angles: checked Angle
+ * (range(0) == 0) or FastAngle
+ */
+void AngleArithmetic(benchmark::State& state)
+{
+   const Circle circle(Point(0, 0), 1);
+   for (auto _ : state) {
+      if (state.range(0) == 0) {
+         Angle angle(0.0);
+         for (int i = 0; i < 1024; ++i) {
+            angle = angle + Angle(0.5);
+            benchmark::DoNotOptimize(circle.getPoint(angle));
+         }
+      } else {
+         FastAngle angle;
+         const FastAngle step = FastAngle::fromDegrees(0.5);
+         for (int i = 0; i < 1024; ++i) {
+            angle = angle + step;
+            benchmark::DoNotOptimize(circle.getPoint(angle));
+         }
+      }
+   }
+   state.SetItemsProcessed(state.iterations() * 1024);
+   state.SetLabel(state.range(0) == 0 ? "Angle" : "FastAngle");
+}
+BENCHMARK(AngleArithmetic)->Arg(0)->Arg(1);
+} // namespace
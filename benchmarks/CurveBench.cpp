@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+
+#include "Curve.hpp"
+#include "CurveFlattener.hpp"
+#include "DataGenerator.hpp"
+
+namespace {
+void CubicBezierCurve(benchmark::State& state)
+{
+   bench::Generator generator;
+   const std::vector<Point> points = generator.points(4, bench::UNIFORM);
+   for (auto _ : state)
+      benchmark::DoNotOptimize(Curve::makeBezierCurve(
+        points[0], points[1], points[2], points[3]));
+}
+BENCHMARK(CubicBezierCurve);
+
+/**
+ * @brief Flattening into a reused buffer, range(0) is the degree and
+ * range(1) is -log10 of the tolerance
+ */
+void FlattenBezier(benchmark::State& state)
+{
+   bench::Generator generator;
+   std::vector<Vector2> controls;
+   for (auto&& p : generator.points(state.range(0) + 1, bench::UNIFORM))
+      controls.push_back(Vector2::from(p));
+   CurveFlattener flattener(std::pow(10.0, -state.range(1)));
+   std::vector<Vector2> out;
+   for (auto _ : state) {
+      out.clear();
+      flattener.bezier(controls.data(), controls.size(), out);
+      benchmark::DoNotOptimize(out.data());
+   }
+   state.counters["points"] = out.size();
+}
+BENCHMARK(FlattenBezier)->ArgsProduct({ { 2, 3, 7 }, { 2, 3, 5 } });
+
+void FlattenBSpline(benchmark::State& state)
+{
+   bench::Generator generator;
+   std::vector<Vector2> controls;
+   for (auto&& p : generator.points(state.range(0), bench::UNIFORM))
+      controls.push_back(Vector2::from(p));
+   CurveFlattener flattener;
+   std::vector<Vector2> out;
+   for (auto _ : state) {
+      out.clear();
+      flattener.bSpline(controls.data(), controls.size(), 3, out);
+      benchmark::DoNotOptimize(out.data());
+   }
+   state.counters["points"] = out.size();
+}
+BENCHMARK(FlattenBSpline)->RangeMultiplier(8)->Range(8, 4096);
+
+void FlattenBezierBatch(benchmark::State& state)
+{
+   bench::Generator generator;
+   std::vector<Vector2> controls;
+   std::vector<size_t> offsets { 0 };
+   for (int64_t i = 0; i < state.range(0); ++i) {
+      for (auto&& p : generator.points(4, bench::UNIFORM))
+         controls.push_back(Vector2::from(p));
+      offsets.push_back(controls.size());
+   }
+   std::vector<Vector2> out;
+   std::vector<size_t> out_offsets;
+   for (auto _ : state)
+      CurveFlattener::bezierBatch(
+        controls, offsets, 0.001, out, out_offsets);
+   state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(FlattenBezierBatch)
+  ->RangeMultiplier(8)
+  ->Range(64, 32768)
+  ->UseRealTime();
+} // namespace
@@ -0,0 +1,168 @@
+#ifndef GEOMETRY_LIB_BENCHMARKS_DATAGENERATOR_HPP
+#define GEOMETRY_LIB_BENCHMARKS_DATAGENERATOR_HPP
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Graph.hpp"
+#include "LineSegment.hpp"
+#include "Point.hpp"
+#include "Polygon.hpp"
+
+/**
+ * @brief Deterministic input data for benchmarks. Every generator takes
+ * a seed, the same seed gives the same data on every run and platform
+ * (std::mt19937 is fully specified, distributions are implemented here
+ * for the same reason).
+ */
+namespace bench {
+const uint32_t defaultSeed = 20240601;
+
+/**
+ * @brief Distribution of generated points
+ */
+enum Shape
+{
+   UNIFORM,   // uniform in the square [-1, 1] x [-1, 1]
+   CLUSTERED, // a few dense gaussian clusters
+   COLLINEAR  // degenerate: all points on one line
+};
+
+inline const char* shapeName(int shape)
+{
+   switch (shape) {
+      case UNIFORM:
+         return "uniform";
+      case CLUSTERED:
+         return "clustered";
+      case COLLINEAR:
+         return "collinear";
+   }
+   return "unknown";
+}
+
+class Generator
+{
+  private:
+   std::mt19937 _engine;
+
+  public:
+   Generator(uint32_t seed = defaultSeed) : _engine(seed) {}
+
+   /**
+    * @brief Uniform number in [min, max)
+    */
+   double uniform(double min = -1, double max = 1)
+   {
+      return min + (max - min) * (_engine() / 4294967296.0);
+   }
+   /**
+    * @brief Normal number by Box-Muller transform
+    */
+   double normal(double mean, double deviation)
+   {
+      const double u = uniform(1e-12, 1), v = uniform(0, 1);
+      return mean + deviation * std::sqrt(-2 * std::log(u)) *
+                      std::cos(2 * M_PI * v);
+   }
+
+   Point point(int shape)
+   {
+      switch (shape) {
+         case CLUSTERED: {
+            // Eight clusters with fixed centres
+            const double angle = (_engine() % 8) * M_PI / 4;
+            return Point(normal(0.6 * std::cos(angle), 0.05),
+                         normal(0.6 * std::sin(angle), 0.05));
+         }
+         case COLLINEAR: {
+            const double t = uniform();
+            return Point(t, 0.5 * t + 0.25);
+         }
+         default:
+            return Point(uniform(), uniform());
+      }
+   }
+   std::vector<Point> points(size_t count, int shape)
+   {
+      std::vector<Point> result;
+      result.reserve(count);
+      for (size_t i = 0; i < count; ++i)
+         result.push_back(point(shape));
+      return result;
+   }
+   std::vector<LineSegment> segments(size_t count, int shape,
+                                     double length = 0.05)
+   {
+      std::vector<LineSegment> result;
+      result.reserve(count);
+      for (size_t i = 0; i < count; ++i) {
+         const Point a = point(shape);
+         const double angle =
+           (shape == COLLINEAR) ? std::atan(0.5) : uniform(0, M_PI);
+         result.emplace_back(
+           a,
+           a + Point(length * std::cos(angle),
+                     length * std::sin(angle)));
+      }
+      return result;
+   }
+   /**
+    * @brief Simple star-shaped polygon with vertices in
+    * counterclockwise order
+    */
+   Polygon starPolygon(size_t size, double radius = 1)
+   {
+      std::vector<Point> result;
+      result.reserve(size);
+      for (size_t i = 0; i < size; ++i) {
+         const double angle = 2 * M_PI * i / size,
+                      r = radius * uniform(0.5, 1);
+         result.emplace_back(r * std::cos(angle), r * std::sin(angle));
+      }
+      return Polygon(result);
+   }
+   /**
+    * @brief Convex polygon, vertices of a regular polygon
+    */
+   static Polygon regularPolygon(size_t size, double radius = 1)
+   {
+      std::vector<Point> result;
+      result.reserve(size);
+      for (size_t i = 0; i < size; ++i) {
+         const double angle = 2 * M_PI * i / size;
+         result.emplace_back(radius * std::cos(angle),
+                             radius * std::sin(angle));
+      }
+      return Polygon(result);
+   }
+   /**
+    * @brief Planar triangulated grid graph side x side
+    *
+    * @param jitter maximal random offset of vertices from the nodes
+    * of the integer grid
+    */
+   Graph gridGraph(size_t side, double jitter = 0.2)
+   {
+      std::vector<Point> points;
+      edge_list_t edges;
+      points.reserve(side * side);
+      for (size_t row = 0; row < side; ++row)
+         for (size_t col = 0; col < side; ++col) {
+            points.emplace_back(col + uniform(-jitter, jitter),
+                                row + uniform(-jitter, jitter));
+            const uint v = row * side + col;
+            if (col + 1 < side)
+               edges.emplace_back(v, v + 1);
+            if (row + 1 < side)
+               edges.emplace_back(v, v + side);
+            if (col + 1 < side && row + 1 < side)
+               edges.emplace_back(v, v + side + 1);
+         }
+      return Graph(edges, points);
+   }
+};
+} // namespace bench
+
+#endif // GEOMETRY_LIB_BENCHMARKS_DATAGENERATOR_HPP
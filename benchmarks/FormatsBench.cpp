@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+
+#include "DataGenerator.hpp"
+#include "GeometryFormats.hpp"
+
+namespace {
+enum Format
+{
+   WKT,
+   WKB,
+   GEOJSON
+};
+
+/**
+ * @brief Polygons of 16 vertices in the given format
+ */
+std::string makeText(Format format, size_t count)
+{
+   bench::Generator generator;
+   GeometryBatch batch;
+   for (size_t i = 0; i < count; ++i)
+      batch.addPolygon(generator.starPolygon(16));
+   std::ostringstream output;
+   switch (format) {
+      case WKT:
+         GeometryFormats::writeWkt(output, batch);
+         break;
+      case WKB:
+         GeometryFormats::writeWkb(output, batch);
+         break;
+      case GEOJSON:
+         GeometryFormats::writeGeoJson(output, batch);
+         break;
+   }
+   return output.str();
+}
+
+template<Format format>
+void ReadFormat(benchmark::State& state)
+{
+   const std::string text = makeText(format, state.range(0));
+   GeometryBatch batch;
+   for (auto _ : state) {
+      std::istringstream input(text);
+      // Batches of 1024 geometries, as a streaming consumer reads them
+      auto read = [&](auto&& reader) {
+         while (reader.read(batch, 1024))
+            batch.clear();
+      };
+      switch (format) {
+         case WKT:
+            read(GeometryFormats::WktReader(input));
+            break;
+         case WKB:
+            read(GeometryFormats::WkbReader(input));
+            break;
+         case GEOJSON:
+            read(GeometryFormats::GeoJsonReader(input));
+            break;
+      }
+   }
+   state.SetBytesProcessed(state.iterations() * text.size());
+   state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(ReadFormat, WKT)->Range(1 << 10, 1 << 14);
+BENCHMARK_TEMPLATE(ReadFormat, WKB)->Range(1 << 10, 1 << 14);
+BENCHMARK_TEMPLATE(ReadFormat, GEOJSON)->Range(1 << 10, 1 << 14);
+
+template<Format format>
+void WriteFormat(benchmark::State& state)
+{
+   bench::Generator generator;
+   GeometryBatch batch;
+   for (int i = 0; i < state.range(0); ++i)
+      batch.addPolygon(generator.starPolygon(16));
+   size_t bytes = 0;
+   for (auto _ : state) {
+      std::ostringstream output;
+      switch (format) {
+         case WKT:
+            GeometryFormats::writeWkt(output, batch);
+            break;
+         case WKB:
+            GeometryFormats::writeWkb(output, batch);
+            break;
+         case GEOJSON:
+            GeometryFormats::writeGeoJson(output, batch);
+            break;
+      }
+      bytes += output.tellp();
+   }
+   state.SetBytesProcessed(bytes);
+}
+BENCHMARK_TEMPLATE(WriteFormat, WKT)->Arg(1 << 14);
+BENCHMARK_TEMPLATE(WriteFormat, WKB)->Arg(1 << 14);
+BENCHMARK_TEMPLATE(WriteFormat, GEOJSON)->Arg(1 << 14);
+} // namespace
@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include "ComplexNumber.hpp"
+#include "DataGenerator.hpp"
+#include "Fractals.hpp"
+
+namespace {
+void MandelbrotSet(benchmark::State& state)
+{
+   const int size = state.range(0);
+   for (auto _ : state)
+      benchmark::DoNotOptimize(Fractals::mandelbrotSet(
+        Point(-2, 1.5), size, size, 3, 3, state.range(1)));
+   state.SetItemsProcessed(state.iterations() * size * size);
+}
+BENCHMARK(MandelbrotSet)
+  ->ArgsProduct({ { 128, 512 }, { 100, 1000 } })
+  ->Unit(benchmark::kMillisecond);
+
+void NewtonFractal(benchmark::State& state)
+{
+   const int size = state.range(0);
+   for (auto _ : state)
+      benchmark::DoNotOptimize(
+        Fractals::NewtonFractal(Point(-2, 2), size, size, 4, 4));
+   state.SetItemsProcessed(state.iterations() * size * size);
+}
+BENCHMARK(NewtonFractal)
+  ->RangeMultiplier(4)
+  ->Range(128, 512)
+  ->Unit(benchmark::kMillisecond);
+
+void PlasmaFractal(benchmark::State& state)
+{
+   srand(bench::defaultSeed);
+   for (auto _ : state)
+      benchmark::DoNotOptimize(Fractals::plasmaFractal(state.range(0)));
+}
+BENCHMARK(PlasmaFractal)->DenseRange(6, 10, 2);
+
+void BrokenPlasmaFractal(benchmark::State& state)
+{
+   srand(bench::defaultSeed);
+   for (auto _ : state)
+      benchmark::DoNotOptimize(
+        Fractals::brokenPlasmaFractal(state.range(0)));
+}
+BENCHMARK(BrokenPlasmaFractal)->DenseRange(6, 10, 2);
+
+void KochSnowflake(benchmark::State& state)
+{
+   // Iterations count is width_px / (max_x - min_x)
+   const Fractals::Area area(state.range(0), 1, { 0, 1 }, { 0, 1 });
+   for (auto _ : state)
+      benchmark::DoNotOptimize(Fractals::geometricFractal(
+        Point(0, 0),
+        area,
+        Fractals::GeometricFractalType::KOCH_SNOWFLAKE));
+}
+BENCHMARK(KochSnowflake)->DenseRange(3, 7, 2);
+
+void ComplexTransform(benchmark::State& state)
+{
+   bench::Generator generator;
+   std::vector<Vector2> points(state.range(0));
+   for (Vector2& p : points)
+      p = { generator.uniform(), generator.uniform() };
+   const ComplexNumber factor =
+     ComplexNumber::rotation(FastAngle::fromDegrees(30), 1.5);
+   std::vector<Vector2> result(points.size());
+   for (auto _ : state) {
+      ComplexNumber::transform(points.data(), points.size(), factor,
+                               ComplexNumber(1, -1), result.data());
+      benchmark::ClobberMemory();
+   }
+   state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(ComplexTransform)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+} // namespace
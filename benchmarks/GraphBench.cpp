@@ -0,0 +1,215 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "DataGenerator.hpp"
+#include "GeometryFile.hpp"
+#include "Graph.hpp"
+#include "VisibilityGraph.hpp"
+
+namespace {
+void LocalizationOfAPoint(benchmark::State& state)
+{
+   bench::Generator generator;
+   const size_t side = state.range(0);
+   // Vertices are not jittered: slab boundaries computed for jittered
+   // vertices do not pass Line::isBelongs precision check
+   const Graph graph = generator.gridGraph(side, 0);
+   std::vector<Point> queries;
+   for (size_t i = 0; i < 64; ++i)
+      queries.emplace_back(generator.uniform(0.5, side - 1.5),
+                           generator.uniform(0.5, side - 1.5));
+   for (auto _ : state)
+      for (auto&& q : queries)
+         benchmark::DoNotOptimize(graph.localizationOfAPoint(q));
+   state.SetItemsProcessed(state.iterations() * queries.size());
+}
+BENCHMARK(LocalizationOfAPoint)->RangeMultiplier(4)->Range(8, 128);
+
+template<Graph::Method m>
+void SpanningTree(benchmark::State& state)
+{
+   bench::Generator generator;
+   const Graph graph = generator.gridGraph(state.range(0));
+   for (auto _ : state)
+      benchmark::DoNotOptimize(graph.getSpanningTree(m));
+   state.SetItemsProcessed(state.iterations() * graph.edgesCount());
+}
+BENCHMARK_TEMPLATE(SpanningTree, Graph::BY_DEPTH)
+  ->RangeMultiplier(4)
+  ->Range(16, 1024);
+BENCHMARK_TEMPLATE(SpanningTree, Graph::BY_WIDTH)
+  ->RangeMultiplier(4)
+  ->Range(16, 1024);
+BENCHMARK_TEMPLATE(SpanningTree, Graph::MINIMUM)
+  ->RangeMultiplier(4)
+  ->Range(16, 1024);
+
+template<Graph::PathMethod m>
+void ShortestPath(benchmark::State& state)
+{
+   bench::Generator generator;
+   const uint side = state.range(0);
+   const Graph graph = generator.gridGraph(side);
+   for (auto _ : state)
+      benchmark::DoNotOptimize(
+        graph.shortestPath(0, side * side - 1, m));
+}
+BENCHMARK_TEMPLATE(ShortestPath, Graph::DIJKSTRA)
+  ->RangeMultiplier(4)
+  ->Range(16, 1024);
+BENCHMARK_TEMPLATE(ShortestPath, Graph::A_STAR)
+  ->RangeMultiplier(4)
+  ->Range(16, 1024);
+
+void ShortestDistances(benchmark::State& state)
+{
+   bench::Generator generator;
+   const uint side = state.range(0);
+   const Graph graph = generator.gridGraph(side);
+   std::vector<uint> sources, targets;
+   for (uint i = 0; i < 16; ++i) {
+      sources.push_back(generator.uniform(0, side * side));
+      targets.push_back(generator.uniform(0, side * side));
+   }
+   for (auto _ : state)
+      benchmark::DoNotOptimize(
+        graph.shortestDistances(sources, targets));
+}
+BENCHMARK(ShortestDistances)->RangeMultiplier(4)->Range(16, 256);
+
+void GraphLoadBinary(benchmark::State& state)
+{
+   bench::Generator generator;
+   const Graph graph = generator.gridGraph(state.range(0));
+   const std::string path = "geometry_bench_graph.bin";
+   GeometryFile::write(path, graph);
+   for (auto _ : state)
+      benchmark::DoNotOptimize(GeometryFile(path).graph());
+   state.SetItemsProcessed(state.iterations() * graph.edgesCount());
+   std::remove(path.c_str());
+}
+BENCHMARK(GraphLoadBinary)
+  ->RangeMultiplier(4)
+  ->Range(64, 1024)
+  ->Unit(benchmark::kMillisecond);
+
+std::string graphText(const Graph& graph, Graph::TextFormat format)
+{
+   std::ostringstream out;
+   out.precision(17);
+   const edge_list_t edges = graph.getEdgeList();
+   if (format == Graph::EDGE_LIST) {
+      out << graph.size() << ' ' << edges.size() << '\n';
+      for (uint v = 0; v < graph.size(); ++v)
+         out << graph.point(v)[0] << ' ' << graph.point(v)[1] << '\n';
+      for (auto&& [u, v] : edges)
+         out << u << ' ' << v << '\n';
+   } else
+      for (auto&& [u, v] : edges)
+         out << graph.point(u)[0] << ' ' << graph.point(u)[1] << ' '
+             << graph.point(v)[0] << ' ' << graph.point(v)[1] << '\n';
+   return out.str();
+}
+
+template<Graph::TextFormat format>
+void GraphParseText(benchmark::State& state)
+{
+   bench::Generator generator;
+   const std::string text =
+     graphText(generator.gridGraph(state.range(0)), format);
+   for (auto _ : state)
+      benchmark::DoNotOptimize(
+        Graph::parse(text.data(), text.size(), format));
+   state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK_TEMPLATE(GraphParseText, Graph::EDGE_LIST)
+  ->RangeMultiplier(4)
+  ->Range(64, 1024)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(GraphParseText, Graph::COORDINATE_LIST)
+  ->RangeMultiplier(4)
+  ->Range(64, 1024)
+  ->Unit(benchmark::kMillisecond);
+
+void GraphLoadText(benchmark::State& state)
+{
+   bench::Generator generator;
+   const std::string text =
+     graphText(generator.gridGraph(state.range(0)), Graph::EDGE_LIST);
+   const std::string path = "geometry_bench_graph.txt";
+   std::ofstream(path) << text;
+   for (auto _ : state)
+      benchmark::DoNotOptimize(Graph::load(path));
+   state.SetBytesProcessed(state.iterations() * text.size());
+   std::remove(path.c_str());
+}
+BENCHMARK(GraphLoadText)
+  ->RangeMultiplier(4)
+  ->Range(64, 1024)
+  ->Unit(benchmark::kMillisecond);
+
+void GraphReadStream(benchmark::State& state)
+{
+   bench::Generator generator;
+   const std::string text =
+     graphText(generator.gridGraph(state.range(0)), Graph::EDGE_LIST);
+   for (auto _ : state) {
+      std::istringstream input(text);
+      Graph graph;
+      input >> graph;
+      benchmark::DoNotOptimize(graph);
+   }
+   state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(GraphReadStream)
+  ->RangeMultiplier(4)
+  ->Range(64, 1024)
+  ->Unit(benchmark::kMillisecond);
+
+std::vector<Polygon> makeObstacles(bench::Generator& generator,
+                                   size_t count)
+{
+   // Small star polygons centred in the cells of a square grid, so
+   // they never overlap
+   const size_t side = std::ceil(std::sqrt(count));
+   std::vector<Polygon> result;
+   for (size_t i = 0; i < count; ++i) {
+      std::vector<Point> points =
+        generator.starPolygon(8, 0.4).get();
+      for (auto&& p : points)
+         p = p + Point(i % side, i / side);
+      result.emplace_back(points);
+   }
+   return result;
+}
+
+void VisibilityGraphBuild(benchmark::State& state)
+{
+   bench::Generator generator;
+   const std::vector<Polygon> obstacles =
+     makeObstacles(generator, state.range(0));
+   for (auto _ : state)
+      benchmark::DoNotOptimize(VisibilityGraph(obstacles));
+   state.SetComplexityN(state.range(0));
+}
+BENCHMARK(VisibilityGraphBuild)->RangeMultiplier(4)->Range(4, 64);
+
+void VisibilityGraphShortestPath(benchmark::State& state)
+{
+   bench::Generator generator;
+   const size_t count = state.range(0),
+                side = std::ceil(std::sqrt(count));
+   const VisibilityGraph graph(makeObstacles(generator, count));
+   graph.graph();
+   const Point from(-1, -1), to(side, side);
+   for (auto _ : state)
+      benchmark::DoNotOptimize(graph.shortestPath(from, to));
+}
+BENCHMARK(VisibilityGraphShortestPath)
+  ->RangeMultiplier(4)
+  ->Range(4, 64);
+} // namespace
@@ -0,0 +1,229 @@
+#include <benchmark/benchmark.h>
+
+#include "Circle.hpp"
+#include "DataGenerator.hpp"
+#include "Polygon.hpp"
+
+namespace {
+const auto shapes = { bench::UNIFORM, bench::CLUSTERED,
+                      bench::COLLINEAR };
+
+void IsInside(benchmark::State& state)
+{
+   bench::Generator generator;
+   const Polygon polygon = generator.starPolygon(state.range(0));
+   const std::vector<Point> queries =
+     generator.points(1024, state.range(1));
+   for (auto _ : state)
+      for (auto&& q : queries)
+         benchmark::DoNotOptimize(polygon.isInside(q));
+   state.SetItemsProcessed(state.iterations() * queries.size());
+   state.SetLabel(bench::shapeName(state.range(1)));
+}
+BENCHMARK(IsInside)->ArgsProduct({ { 8, 64, 512, 4096 },
+                                   { shapes.begin(), shapes.end() } });
+
+template<Polygon::ConvexHullMethod m>
+void ConvexHull(benchmark::State& state)
+{
+   bench::Generator generator;
+   const std::vector<Point> points =
+     generator.points(state.range(0), state.range(1));
+   for (auto _ : state)
+      benchmark::DoNotOptimize(Polygon::convexHull(points, m));
+   state.SetComplexityN(state.range(0));
+   state.SetItemsProcessed(state.iterations() * points.size());
+   state.SetLabel(bench::shapeName(state.range(1)));
+}
+BENCHMARK_TEMPLATE(ConvexHull, Polygon::GRAHAM)
+  ->ArgsProduct({ { 256, 4096, 65536 },
+                  { bench::UNIFORM, bench::CLUSTERED } });
+BENCHMARK_TEMPLATE(ConvexHull, Polygon::JARVIS)
+  ->ArgsProduct({ { 256, 4096, 65536 },
+                  { bench::UNIFORM, bench::CLUSTERED } });
+
+template<Polygon::ClipSegmentMethod m>
+void SegmentInsidePolygon(benchmark::State& state)
+{
+   bench::Generator generator;
+   const Polygon square = Polygon::makeByArea({ -0.5, 0.5 },
+                                              { -0.5, 0.5 });
+   const std::vector<LineSegment> segments =
+     generator.segments(1024, state.range(0), 0.5);
+   for (auto _ : state)
+      for (auto&& s : segments)
+         benchmark::DoNotOptimize(square.segmentInsidePolygon(s, m));
+   state.SetItemsProcessed(state.iterations() * segments.size());
+   state.SetLabel(bench::shapeName(state.range(0)));
+}
+BENCHMARK_TEMPLATE(SegmentInsidePolygon, Polygon::COHEN_SUTHERLAND)
+  ->DenseRange(bench::UNIFORM, bench::COLLINEAR);
+BENCHMARK_TEMPLATE(SegmentInsidePolygon, Polygon::SPROULE_SUTHERLAND)
+  ->DenseRange(bench::UNIFORM, bench::COLLINEAR);
+BENCHMARK_TEMPLATE(SegmentInsidePolygon, Polygon::CYRUS_BECK)
+  ->DenseRange(bench::UNIFORM, bench::COLLINEAR);
+
+template<Polygon::LocaliztionMethod m>
+void PointsInsidePolygon(benchmark::State& state)
+{
+   bench::Generator generator;
+   const Polygon square = Polygon::makeByArea({ -0.5, 0.5 },
+                                              { -0.5, 0.5 });
+   const std::vector<Point> points =
+     generator.points(state.range(0), state.range(1));
+   for (auto _ : state)
+      benchmark::DoNotOptimize(square.pointsInsidePolygon(points, m));
+   state.SetItemsProcessed(state.iterations() * points.size());
+   state.SetLabel(bench::shapeName(state.range(1)));
+}
+BENCHMARK_TEMPLATE(PointsInsidePolygon, Polygon::SIMPLE)
+  ->ArgsProduct({ { 1024, 16384, 262144 },
+                  { shapes.begin(), shapes.end() } });
+BENCHMARK_TEMPLATE(PointsInsidePolygon, Polygon::GRID)
+  ->ArgsProduct({ { 1024, 16384 }, { shapes.begin(), shapes.end() } });
+
+void IsSimple(benchmark::State& state)
+{
+   bench::Generator generator;
+   const Polygon polygon = generator.starPolygon(state.range(0));
+   for (auto _ : state)
+      benchmark::DoNotOptimize(polygon.isSimple());
+   state.SetComplexityN(state.range(0));
+}
+BENCHMARK(IsSimple)->RangeMultiplier(8)->Range(8, 4096);
+
+void IsConvex(benchmark::State& state)
+{
+   const Polygon polygon =
+     bench::Generator::regularPolygon(state.range(0));
+   for (auto _ : state)
+      benchmark::DoNotOptimize(polygon.isConvex());
+   state.SetComplexityN(state.range(0));
+}
+BENCHMARK(IsConvex)->RangeMultiplier(8)->Range(8, 32768);
+
+template<PolygonProperties::Summation s>
+void Properties(benchmark::State& state)
+{
+   bench::Generator generator;
+   const Polygon polygon = generator.starPolygon(state.range(0));
+   for (auto _ : state)
+      benchmark::DoNotOptimize(polygon.properties(s));
+   state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(Properties, PolygonProperties::FAST)
+  ->RangeMultiplier(8)
+  ->Range(8, 32768);
+BENCHMARK_TEMPLATE(Properties, PolygonProperties::COMPENSATED)
+  ->RangeMultiplier(8)
+  ->Range(8, 32768);
+
+template<Polygon::TriangulationMethod m>
+void Triangulate(benchmark::State& state)
+{
+   bench::Generator generator;
+   const Polygon polygon = generator.starPolygon(state.range(0));
+   for (auto _ : state)
+      benchmark::DoNotOptimize(polygon.triangulate(m));
+   state.SetComplexityN(state.range(0));
+   state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(Triangulate, Polygon::EAR_CLIPPING)
+  ->RangeMultiplier(8)
+  ->Range(8, 4096);
+BENCHMARK_TEMPLATE(Triangulate, Polygon::MONOTONE_PARTITION)
+  ->RangeMultiplier(8)
+  ->Range(8, 32768);
+
+template<Simplification::Method m>
+void Simplify(benchmark::State& state)
+{
+   bench::Generator generator;
+   const Polygon polygon = generator.starPolygon(state.range(0));
+   // Tolerances remove about a half of star vertices
+   const double tolerance =
+     (m == Simplification::DOUGLAS_PEUCKER) ? 0.1 : 1e-3;
+   for (auto _ : state)
+      benchmark::DoNotOptimize(polygon.simplify(tolerance, m));
+   state.SetComplexityN(state.range(0));
+   state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(Simplify, Simplification::DOUGLAS_PEUCKER)
+  ->RangeMultiplier(8)
+  ->Range(64, 262144);
+BENCHMARK_TEMPLATE(Simplify, Simplification::VISVALINGAM_WHYATT)
+  ->RangeMultiplier(8)
+  ->Range(64, 262144);
+
+void Calipers(benchmark::State& state)
+{
+   const Polygon hull =
+     bench::Generator::regularPolygon(state.range(0));
+   for (auto _ : state)
+      benchmark::DoNotOptimize(hull.calipers());
+   state.SetComplexityN(state.range(0));
+   state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(Calipers)->RangeMultiplier(8)->Range(8, 32768);
+
+void MinEnclosingCircle(benchmark::State& state)
+{
+   bench::Generator generator;
+   const std::vector<Point> points =
+     generator.points(state.range(0), state.range(1));
+   for (auto _ : state)
+      benchmark::DoNotOptimize(Circle::minEnclosing(points));
+   state.SetComplexityN(state.range(0));
+   state.SetItemsProcessed(state.iterations() * state.range(0));
+   state.SetLabel(bench::shapeName(state.range(1)));
+}
+BENCHMARK(MinEnclosingCircle)
+  ->ArgsProduct({ { 1024, 16384, 262144 },
+                  { shapes.begin(), shapes.end() } });
+
+void MinEnclosingCircleBatch(benchmark::State& state)
+{
+   // Many small clusters, as in per-object bounding circles
+   bench::Generator generator;
+   std::vector<Vector2> points;
+   std::vector<size_t> offsets = { 0 };
+   for (int i = 0; i < state.range(0); ++i) {
+      for (auto&& p : generator.points(16, bench::CLUSTERED))
+         points.push_back(Vector2::from(p));
+      offsets.push_back(points.size());
+   }
+   for (auto _ : state)
+      benchmark::DoNotOptimize(Circle::minEnclosingBatch(points, offsets));
+   state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(MinEnclosingCircleBatch)->RangeMultiplier(8)->Range(64, 32768);
+
+template<bool is_projective>
+void TransformPoints(benchmark::State& state)
+{
+   bench::Generator generator;
+   std::vector<Vector2> points;
+   for (auto&& p : generator.points(state.range(0), bench::UNIFORM))
+      points.push_back(Vector2::from(p));
+   // A chain of transforms is applied as one matrix
+   Transform transform =
+     Transform::rotation(FastAngle::fromDegrees(30), { 1, 1 })
+       .then(Transform::scaling(2, 0.5))
+       .then(Transform::translation({ -1, 3 }));
+   if (is_projective)
+      transform = transform.then(
+        Transform::projective({ 1, 0, 0, 0, 1, 0, 0.1, 0.1, 1 }));
+   std::vector<Vector2> result(points.size());
+   for (auto _ : state) {
+      transform.apply(points.data(), points.size(), result.data());
+      benchmark::ClobberMemory();
+   }
+   state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK_TEMPLATE(TransformPoints, false)
+  ->RangeMultiplier(16)
+  ->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(TransformPoints, true)
+  ->RangeMultiplier(16)
+  ->Range(1 << 10, 1 << 18);
+} // namespace
@@ -0,0 +1,166 @@
+#include <benchmark/benchmark.h>
+
+#include "DataGenerator.hpp"
+#include "HomogeneousLine.hpp"
+#include "Line.hpp"
+#include "LineSegment.hpp"
+#include "SegmentGrid.hpp"
+
+namespace {
+void SegmentPairIntersection(benchmark::State& state)
+{
+   bench::Generator generator;
+   const std::vector<LineSegment> segments =
+     generator.segments(2048, state.range(0), 0.5);
+   for (auto _ : state)
+      for (size_t i = 0; i + 1 < segments.size(); i += 2)
+         benchmark::DoNotOptimize(
+           segments[i].isIntersection(segments[i + 1]));
+   state.SetItemsProcessed(state.iterations() * segments.size() / 2);
+   state.SetLabel(bench::shapeName(state.range(0)));
+}
+BENCHMARK(SegmentPairIntersection)
+  ->DenseRange(bench::UNIFORM, bench::COLLINEAR);
+
+void PointsIntersection(benchmark::State& state)
+{
+   bench::Generator generator;
+   const std::vector<Point> points =
+     generator.points(4096, state.range(0));
+   for (auto _ : state)
+      for (size_t i = 0; i + 3 < points.size(); i += 4)
+         benchmark::DoNotOptimize(LineSegment::isIntersection(
+           points[i], points[i + 1], points[i + 2], points[i + 3]));
+   state.SetItemsProcessed(state.iterations() * points.size() / 4);
+   state.SetLabel(bench::shapeName(state.range(0)));
+}
+BENCHMARK(PointsIntersection)
+  ->DenseRange(bench::UNIFORM, bench::COLLINEAR);
+
+/**
+ * @brief Sweep line check of a whole set, the segments are short so
+ * the answer is usually found late
+ */
+void AnyIntersection(benchmark::State& state)
+{
+   bench::Generator generator;
+   const std::vector<LineSegment> segments = generator.segments(
+     state.range(0), state.range(1), 0.5 / state.range(0));
+   for (auto _ : state)
+      benchmark::DoNotOptimize(LineSegment::isIntersection(segments));
+   state.SetComplexityN(state.range(0));
+   state.SetLabel(bench::shapeName(state.range(1)));
+}
+BENCHMARK(AnyIntersection)
+  ->ArgsProduct({ { 256, 4096, 65536 },
+                  { bench::UNIFORM, bench::CLUSTERED } });
+
+void IsBelongs(benchmark::State& state)
+{
+   bench::Generator generator;
+   const std::vector<LineSegment> segments =
+     generator.segments(1024, state.range(0), 0.5);
+   const std::vector<Point> points =
+     generator.points(1024, state.range(0));
+   for (auto _ : state)
+      for (size_t i = 0; i < segments.size(); ++i)
+         benchmark::DoNotOptimize(segments[i].isBelongs(points[i]));
+   state.SetItemsProcessed(state.iterations() * segments.size());
+   state.SetLabel(bench::shapeName(state.range(0)));
+}
+BENCHMARK(IsBelongs)->DenseRange(bench::UNIFORM, bench::COLLINEAR);
+
+void CompactIntersectPairs(benchmark::State& state)
+{
+   bench::Generator generator;
+   const std::vector<CompactSegment> a = LineSegment::compact(
+                                       generator.segments(
+                                         4096, state.range(0), 0.5)),
+                                     b = LineSegment::compact(
+                                       generator.segments(
+                                         4096, state.range(0), 0.5));
+   std::vector<uint8_t> result(a.size());
+   for (auto _ : state) {
+      CompactSegment::intersectPairs(
+        a.data(), b.data(), a.size(), result.data());
+      benchmark::DoNotOptimize(result.data());
+   }
+   state.SetItemsProcessed(state.iterations() * a.size());
+   state.SetLabel(bench::shapeName(state.range(0)));
+}
+BENCHMARK(CompactIntersectPairs)
+  ->DenseRange(bench::UNIFORM, bench::COLLINEAR);
+
+void CompactIntersectAll(benchmark::State& state)
+{
+   bench::Generator generator;
+   const std::vector<CompactSegment> segments = LineSegment::compact(
+     generator.segments(state.range(0), bench::UNIFORM, 0.05));
+   const CompactSegment query =
+     CompactSegment::make({ -1, -1 }, { 1, 1 });
+   std::vector<uint> hits(segments.size());
+   for (auto _ : state)
+      benchmark::DoNotOptimize(CompactSegment::intersectAll(
+        query, segments.data(), segments.size(), hits.data()));
+   state.SetItemsProcessed(state.iterations() * segments.size());
+}
+BENCHMARK(CompactIntersectAll)->RangeMultiplier(8)->Range(512, 262144);
+
+/**
+ * @brief All intersecting pairs: grid build, broad and narrow phases.
+ * Segment length shrinks with count so that density is constant.
+ */
+void SegmentGridIntersectingPairs(benchmark::State& state)
+{
+   bench::Generator generator;
+   const std::vector<CompactSegment> segments =
+     LineSegment::compact(generator.segments(
+       state.range(0), state.range(1), 2.0 / std::sqrt(state.range(0))));
+   size_t pairs = 0;
+   for (auto _ : state) {
+      SegmentGrid grid(segments);
+      pairs = grid.intersectingPairs().size();
+   }
+   state.counters["pairs"] = pairs;
+   state.SetItemsProcessed(state.iterations() * segments.size());
+   state.SetLabel(bench::shapeName(state.range(1)));
+}
+BENCHMARK(SegmentGridIntersectingPairs)
+  ->ArgsProduct({ { 4096, 65536, 1048576 },
+                  { bench::UNIFORM, bench::CLUSTERED } })
+  ->Unit(benchmark::kMillisecond)
+  ->UseRealTime();
+
+/**
+ * @brief One line against many: Line::intersect (range(0) == 0) or
+ * the HomogeneousLine batch kernel
+ */
+void LineIntersectMany(benchmark::State& state)
+{
+   bench::Generator generator;
+   const std::vector<Point> points = generator.points(8192, bench::UNIFORM);
+   std::vector<Line> lines;
+   std::vector<HomogeneousLine> equations;
+   for (size_t i = 0; i + 1 < points.size(); i += 2) {
+      lines.emplace_back(points[i], points[i + 1]);
+      equations.push_back(lines.back().homogeneous());
+   }
+   const Line line(Point(0, 0), Point(1, 3));
+   std::vector<Vector2> result(equations.size());
+   for (auto _ : state) {
+      if (state.range(0) == 0) {
+         for (auto&& other : lines)
+            benchmark::DoNotOptimize(Line::intersect(line, other));
+      } else {
+         HomogeneousLine::intersect(line.homogeneous(),
+                                    equations.data(),
+                                    equations.size(),
+                                    result.data());
+         benchmark::DoNotOptimize(result.data());
+      }
+   }
+   state.SetItemsProcessed(state.iterations() * lines.size());
+   state.SetLabel(state.range(0) == 0 ? "Line" : "batch");
+}
+BENCHMARK(LineIntersectMany)->Arg(0)->Arg(1);
+} // namespace